@@ -1,15 +1,23 @@
 // Function definitions for the AnalogLed class. 
 
 // @author Janette H. Griggs
-// @version 1.4 04/09/14
+// @version 1.21 10/19/26
 
 #include "AnalogLed.h"
+#include <util/atomic.h>
+
+AnalogLed::WriteObserver AnalogLed::s_writeObserver = NULL;
+unsigned long AnalogLed::s_currentBudget = 0L;
+unsigned long AnalogLed::s_totalCurrent = 0L;
+unsigned int AnalogLed::s_budgetScale = 256;
 
 AnalogLed::AnalogLed(int ledPinNumber, 
                      int minBrightness, 
                      int maxBrightness, 
                      LedType ledType) {
   m_ledType = ledType;
+  m_brightnessTop = 255;
+  m_pwmResolution = 8;
 
   if (m_ledType == COMMON_CATHODE) {
     m_minBrightness = minBrightness;
@@ -17,8 +25,8 @@ AnalogLed::AnalogLed(int ledPinNumber,
   } 
   
   if (m_ledType == COMMON_ANODE) {
-    m_minBrightness = 255 - minBrightness;
-    m_maxBrightness = 255 - maxBrightness;
+    m_minBrightness = m_brightnessTop - minBrightness;
+    m_maxBrightness = m_brightnessTop - maxBrightness;
   }
 
   m_brightnessChangeTimer = 0L;
@@ -26,11 +34,22 @@ AnalogLed::AnalogLed(int ledPinNumber,
   m_activeTimer = 0L;
   m_isActive = false;
   m_direction = ZERO;
+  m_isDithering = false;
+  m_ditherError = 0;
+  m_isSeamlessTransition = false;
+  m_isCarryingRemainder = false;
+  resetTelemetry();
+  m_budgetCurrent = 0;
+  m_budgetScale = 256;
+  setLedCurrent(DEFAULT_LED_CURRENT);
 
   setLedPinNumber(ledPinNumber);
   setToMinBrightness();
 }
 
+AnalogLed::AnalogLed() : AnalogLed(NO_LED_PIN) {
+}
+
 int AnalogLed::getLedPinNumber() const {
   return m_ledPinNumber;
 }
@@ -67,11 +86,41 @@ BrightnessChangeMode AnalogLed::getBrightnessChangeMode() const {
   return m_brightnessChangeMode;
 }
 
+bool AnalogLed::getIsDitheringState() const {
+  return m_isDithering;
+}
+
+byte AnalogLed::getPwmResolution() const {
+  return m_pwmResolution;
+}
+
+bool AnalogLed::getIsSeamlessTransitionState() const {
+  return m_isSeamlessTransition;
+}
+
+unsigned int AnalogLed::getLateUpdateCount() const {
+  return m_lateUpdateCount;
+}
+
+unsigned long AnalogLed::getLostRemainderTime() const {
+  return m_lostRemainderTime;
+}
+
+unsigned long AnalogLed::getMaxOvershoot() const {
+  return m_maxOvershoot;
+}
+
+bool AnalogLed::getIsCarryingRemainderState() const {
+  return m_isCarryingRemainder;
+}
+
 void AnalogLed::setLedPinNumber(int ledPinNumber) {
   m_ledPinNumber = ledPinNumber;
 
   // Set pin mode to output.
-  pinMode(m_ledPinNumber, OUTPUT);
+  if (m_ledPinNumber != NO_LED_PIN) {
+    pinMode(m_ledPinNumber, OUTPUT);
+  }
 }
 
 void AnalogLed::setMinBrightness(int minBrightness) {
@@ -80,7 +129,7 @@ void AnalogLed::setMinBrightness(int minBrightness) {
   }
   
   if (m_ledType == COMMON_ANODE) {
-    m_minBrightness = 255 - minBrightness;
+    m_minBrightness = m_brightnessTop - minBrightness;
   }
 }
 
@@ -90,8 +139,91 @@ void AnalogLed::setMaxBrightness(int maxBrightness) {
   } 
   
   if (m_ledType == COMMON_ANODE) {
-    m_maxBrightness = 255 - maxBrightness;
+    m_maxBrightness = m_brightnessTop - maxBrightness;
+  }
+}
+
+void AnalogLed::setDithering(bool isDithering) {
+  m_isDithering = isDithering;
+  m_ditherError = 0;
+}
+
+void AnalogLed::setSeamlessTransition(bool isSeamlessTransition) {
+  m_isSeamlessTransition = isSeamlessTransition;
+}
+
+void AnalogLed::setCarryingRemainder(bool isCarryingRemainder) {
+  m_isCarryingRemainder = isCarryingRemainder;
+}
+
+void AnalogLed::setPwmResolution(byte pwmResolution) {
+  unsigned int brightnessTop = 255;
+
+  if ((m_ledPinNumber == 9 || m_ledPinNumber == 10) &&
+      pwmResolution > 8 && pwmResolution <= 15) {
+    brightnessTop = (unsigned int) ((1UL << pwmResolution) - 1);
+    m_pwmResolution = pwmResolution;
+
+    // Keep the pin low while it is disconnected from the timer.
+    digitalWrite(m_ledPinNumber, LOW);
+
+    // Fast PWM with ICR1 as TOP (mode 14), no prescaling. The output
+    // compare bits of the other Timer1 pin are left as they are.
+    TCCR1A = (TCCR1A & (_BV(COM1A1) | _BV(COM1B1))) | _BV(WGM11);
+    TCCR1B = _BV(WGM13) | _BV(WGM12) | _BV(CS10);
+    ICR1 = brightnessTop;
+  } else if (m_pwmResolution > 8) {
+    m_pwmResolution = 8;
+
+    // Restore the 8-bit phase correct PWM mode set up by the Arduino
+    // core so analogWrite() works on pins 9 and 10 again. The output
+    // compare bits of the other Timer1 pin are left as they are.
+    TCCR1A = (TCCR1A & (_BV(COM1A1) | _BV(COM1B1))) | _BV(WGM10);
+    TCCR1B = _BV(CS11) | _BV(CS10);
   }
+
+  // Rescale the brightness values to the new resolution.
+  m_minBrightness = (unsigned long) m_minBrightness * brightnessTop / 
+                    m_brightnessTop;
+  m_maxBrightness = (unsigned long) m_maxBrightness * brightnessTop / 
+                    m_brightnessTop;
+  m_currentBrightness = m_currentBrightness * brightnessTop / 
+                        m_brightnessTop;
+  m_brightnessTop = brightnessTop;
+  m_ditherError = 0;
+  setLedCurrent(m_ledCurrent);
+
+  writeBrightness();
+}
+
+AnalogLed::WriteObserver AnalogLed::getWriteObserver() {
+  return s_writeObserver;
+}
+
+void AnalogLed::setWriteObserver(WriteObserver writeObserver) {
+  s_writeObserver = writeObserver;
+}
+
+byte AnalogLed::getLedCurrent() const {
+  return m_ledCurrent;
+}
+
+void AnalogLed::setLedCurrent(byte ledCurrent) {
+  m_ledCurrent = ledCurrent;
+  m_currentFactor = ((unsigned long) ledCurrent << 16) / m_brightnessTop;
+}
+
+unsigned int AnalogLed::getTotalCurrent() {
+  return s_totalCurrent >> 8;
+}
+
+unsigned int AnalogLed::getBudgetScale() {
+  return s_budgetScale;
+}
+
+void AnalogLed::setCurrentBudget(unsigned int currentBudget) {
+  s_currentBudget = (unsigned long) currentBudget << 8;
+  updateBudgetScale();
 }
 
 void AnalogLed::showSteadyLed(unsigned long deltaMillis) {
@@ -107,15 +239,29 @@ void AnalogLed::showBlinkingLed(unsigned long deltaMillis,
   if (m_brightnessChangeMode != BLINK) {
     m_brightnessChangeTimer = 0L;
     m_brightnessChangeMode = BLINK;
-    setToMaxBrightness();
 
-    if (m_ledType == COMMON_CATHODE) {
-      m_direction = NEGATIVE;
+    // Start blinking from the brightness nearest to the current one.
+    if (m_isSeamlessTransition && calculateBrightnessLevel() < 0.5) {
+      setToMinBrightness();
+
+      if (m_ledType == COMMON_CATHODE) {
+        m_direction = POSITIVE;
+      }
+      
+      if (m_ledType == COMMON_ANODE) {
+        m_direction = NEGATIVE;
+      } 
+    } else {
+      setToMaxBrightness();
+
+      if (m_ledType == COMMON_CATHODE) {
+        m_direction = NEGATIVE;
+      }
+      
+      if (m_ledType == COMMON_ANODE) {
+        m_direction = POSITIVE;
+      } 
     }
-    
-    if (m_ledType == COMMON_ANODE) {
-      m_direction = POSITIVE;
-    } 
   } else {
     m_brightnessChangeTimer += deltaMillis;
     
@@ -129,7 +275,7 @@ void AnalogLed::showBlinkingLed(unsigned long deltaMillis,
         m_direction = POSITIVE;
       }
 
-      m_brightnessChangeTimer = 0L;
+      restartBrightnessChange(blinkInterval);
     }
     
     if (m_ledType == COMMON_ANODE && 
@@ -142,7 +288,7 @@ void AnalogLed::showBlinkingLed(unsigned long deltaMillis,
         m_direction = NEGATIVE;
       }
 
-      m_brightnessChangeTimer = 0L;
+      restartBrightnessChange(blinkInterval);
     }
   }
 }
@@ -152,9 +298,17 @@ void AnalogLed::showFadingInLed(unsigned long deltaMillis,
   activateLed(deltaMillis);
 
   if (m_brightnessChangeMode != FADE_IN) {
-    m_brightnessChangeTimer = 0L;
+    // Continue fading in from the current brightness, with the timer
+    // set to where the fade would be at this brightness.
+    if (m_isSeamlessTransition) {
+      m_brightnessChangeTimer = (unsigned long) 
+          (calculateBrightnessLevel() * fadeInterval);
+    } else {
+      m_brightnessChangeTimer = 0L;
+      setToMinBrightness();
+    }
+
     m_brightnessChangeMode = FADE_IN;
-    setToMinBrightness();
     
     if (m_ledType == COMMON_CATHODE) {
       m_direction = POSITIVE;
@@ -165,14 +319,12 @@ void AnalogLed::showFadingInLed(unsigned long deltaMillis,
     }
   } else {
     m_brightnessChangeTimer += deltaMillis;
-    m_currentBrightness += calculateBrightnessChange(deltaMillis,
-                                      fadeInterval);
     
     if (m_brightnessChangeTimer > fadeInterval) {
       setToMinBrightness();
-      m_brightnessChangeTimer = 0L;
+      restartBrightnessChange(fadeInterval);
     } else {
-      analogWrite(m_ledPinNumber, (int) m_currentBrightness);
+      followBrightnessChange(fadeInterval);
     }
 
     /*
@@ -216,9 +368,17 @@ void AnalogLed::showFadingOutLed(unsigned long deltaMillis,
   activateLed(deltaMillis);
 
   if (m_brightnessChangeMode != FADE_OUT) {
-    m_brightnessChangeTimer = 0L;
+    // Continue fading out from the current brightness, with the timer
+    // set to where the fade would be at this brightness.
+    if (m_isSeamlessTransition) {
+      m_brightnessChangeTimer = (unsigned long) 
+          ((1 - calculateBrightnessLevel()) * fadeInterval);
+    } else {
+      m_brightnessChangeTimer = 0L;
+      setToMaxBrightness();
+    }
+
     m_brightnessChangeMode = FADE_OUT;
-    setToMaxBrightness();
     
     if (m_ledType == COMMON_CATHODE) {
       m_direction = NEGATIVE;
@@ -229,14 +389,12 @@ void AnalogLed::showFadingOutLed(unsigned long deltaMillis,
     }
   } else {
     m_brightnessChangeTimer += deltaMillis;
-    m_currentBrightness += calculateBrightnessChange(deltaMillis,
-                                      fadeInterval);  
 
     if (m_brightnessChangeTimer > fadeInterval) {
       setToMaxBrightness();
-      m_brightnessChangeTimer = 0L;
+      restartBrightnessChange(fadeInterval);
     } else {
-      analogWrite(m_ledPinNumber, (int) m_currentBrightness);
+      followBrightnessChange(fadeInterval);
     }
 
     /*
@@ -280,21 +438,47 @@ void AnalogLed::showFadingInOutLed(unsigned long deltaMillis,
   activateLed(deltaMillis);
 
   if (m_brightnessChangeMode != FADE_IN_OUT) {
-    m_brightnessChangeTimer = 0L;
+    bool isFadingOut = false;
+
+    // Continue from the current brightness, fading out if the LED was
+    // fading out or is at its maximum brightness and fading in
+    // otherwise, with the timer set to where the fade would be at this
+    // brightness.
+    if (m_isSeamlessTransition) {
+      float brightnessLevel = calculateBrightnessLevel();
+
+      if (m_brightnessChangeMode == FADE_OUT || brightnessLevel >= 1) {
+        isFadingOut = true;
+        m_brightnessChangeTimer = (unsigned long) 
+            ((1 - brightnessLevel) * fadeInterval);
+      } else {
+        m_brightnessChangeTimer = (unsigned long) 
+            (brightnessLevel * fadeInterval);
+      }
+    } else {
+      m_brightnessChangeTimer = 0L;
+      setToMinBrightness();
+    }
+
     m_brightnessChangeMode = FADE_IN_OUT;
-    setToMinBrightness();
 
     if (m_ledType == COMMON_CATHODE) {
-      m_direction = POSITIVE;
+      if (isFadingOut) {
+        m_direction = NEGATIVE;
+      } else {
+        m_direction = POSITIVE;
+      }
     }
     
     if (m_ledType == COMMON_ANODE) {
-      m_direction = NEGATIVE;
+      if (isFadingOut) {
+        m_direction = POSITIVE;
+      } else {
+        m_direction = NEGATIVE;
+      }
     }
   } else {
     m_brightnessChangeTimer += deltaMillis;
-    m_currentBrightness += calculateBrightnessChange(deltaMillis,
-                                      fadeInterval);
     
     if (m_ledType == COMMON_CATHODE && 
         m_brightnessChangeTimer >= fadeInterval) {
@@ -306,9 +490,9 @@ void AnalogLed::showFadingInOutLed(unsigned long deltaMillis,
         m_direction = POSITIVE;
       }
 
-      m_brightnessChangeTimer = 0L;
+      restartBrightnessChange(fadeInterval);
     } else if (m_ledType == COMMON_CATHODE) {
-      analogWrite(m_ledPinNumber, (int) m_currentBrightness);
+      followBrightnessChange(fadeInterval);
     }
     
     if (m_ledType == COMMON_ANODE && 
@@ -321,22 +505,67 @@ void AnalogLed::showFadingInOutLed(unsigned long deltaMillis,
         m_direction = NEGATIVE;
       }
 
-      m_brightnessChangeTimer = 0L;
+      restartBrightnessChange(fadeInterval);
     } else if (m_ledType == COMMON_ANODE) {
-      analogWrite(m_ledPinNumber, (int) m_currentBrightness);
+      followBrightnessChange(fadeInterval);
     }   
   }
 }
 
+void AnalogLed::resetTelemetry() {
+  m_lateUpdateCount = 0;
+  m_lostRemainderTime = 0L;
+  m_maxOvershoot = 0L;
+}
+
+void AnalogLed::saveSnapshot(LedSnapshot& snapshot) const {
+  float currentBrightness;
+
+  // Only copy the state with interrupts off, so an update from an
+  // interrupt can't change it partway through. The brightness is
+  // rounded afterwards.
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    snapshot.mode = m_brightnessChangeMode;
+
+    // Bit 0 is the active state and bits 1 and 2 are the direction + 1.
+    snapshot.flags = m_isActive | ((m_direction + 1) << 1);
+    currentBrightness = m_currentBrightness;
+    snapshot.changeTimer = m_brightnessChangeTimer;
+    snapshot.activeTimer = m_activeTimer;
+  }
+
+  if (currentBrightness > 0) {
+    snapshot.brightness = (unsigned int) (currentBrightness + 0.5);
+  } else {
+    snapshot.brightness = 0;
+  }
+}
+
+void AnalogLed::restoreSnapshot(const LedSnapshot& snapshot) {
+  float currentBrightness = snapshot.brightness;
+
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    m_brightnessChangeMode = (BrightnessChangeMode) snapshot.mode;
+    m_isActive = snapshot.flags & 1;
+    m_direction = (Direction) (((snapshot.flags >> 1) & 3) - 1);
+    m_currentBrightness = currentBrightness;
+    m_brightnessChangeTimer = snapshot.changeTimer;
+    m_activeTimer = snapshot.activeTimer;
+  }
+
+  writeBrightness();
+}
+
 void AnalogLed::resetLed() {
   stopChangingBrightness();
   setToMinBrightness();
+  removeBudgetCurrent();
   m_activeTimer = 0L;
   m_isActive = false;
 }
 
 AnalogLed::~AnalogLed() {
-
+  removeBudgetCurrent();
 }
 
 void AnalogLed::stopChangingBrightness() {
@@ -345,39 +574,230 @@ void AnalogLed::stopChangingBrightness() {
   m_direction = ZERO;
 }
 
+void AnalogLed::restartBrightnessChange(unsigned long changeInterval) {
+  unsigned long overshoot = m_brightnessChangeTimer - changeInterval;
+
+  m_brightnessChangeTimer = 0L;
+
+  if (overshoot > 0) {
+    if (overshoot > m_maxOvershoot) {
+      m_maxOvershoot = overshoot;
+    }
+
+    // Whole intervals that were skipped can't be made up, so only the
+    // part of the overshoot within the next interval is carried.
+    if (m_isCarryingRemainder && changeInterval > 0) {
+      m_brightnessChangeTimer = overshoot % changeInterval;
+    }
+
+    m_lostRemainderTime += overshoot - m_brightnessChangeTimer;
+
+    if (m_lateUpdateCount < 0xFFFF) {
+      m_lateUpdateCount++;
+    }
+  }
+
+  // A fade continues from where it would be after the carried time.
+  if (m_brightnessChangeTimer > 0 && m_brightnessChangeMode != BLINK) {
+    followBrightnessChange(changeInterval);
+  }
+}
+
 void AnalogLed::activateLed(unsigned long deltaMillis) {
   if (!m_isActive) { 
     m_isActive = true;
   } else {
     m_activeTimer += deltaMillis;
   }
+
+  // Apply a changed budget scale even if this update doesn't change
+  // the brightness, e.g. between blinks. An LED that is off isn't 
+  // scaled.
+  if (m_budgetScale != s_budgetScale && m_budgetCurrent > 0) {
+    writeBrightness();
+  }
 }
 
 void AnalogLed::setToMaxBrightness() {
   m_currentBrightness = m_maxBrightness;
-  analogWrite(m_ledPinNumber, (int) m_currentBrightness);
+  writeBrightness();
 }
 
 void AnalogLed::setToMinBrightness() {
   m_currentBrightness = m_minBrightness;
-  analogWrite(m_ledPinNumber, (int) m_currentBrightness);
+  writeBrightness();
 }
 
-float AnalogLed::calculateBrightnessChange(unsigned long deltaMillis,
-                                unsigned long minToMaxBrightnessInterval) {
-  float brightnessChange;
+void AnalogLed::writeBrightness() {
+  unsigned int brightness = 0;
 
-  if (m_ledType == COMMON_CATHODE) {
-    brightnessChange = (m_maxBrightness -  m_minBrightness) / 
-                       (float) minToMaxBrightnessInterval *
-                       deltaMillis * m_direction;
+  if (m_currentBrightness > 0) {
+    brightness = (unsigned int) m_currentBrightness;
   }
-    
+
+  // Add the fractional part of the brightness (in 1/256 steps) to the
+  // error left over from the previous update. Whenever the sum carries
+  // over, the output is one step brighter for this update, so the
+  // average output over successive PWM frames matches the calculated
+  // brightness.
+  if (m_isDithering && m_currentBrightness > 0 && 
+      brightness < m_brightnessTop) {
+    unsigned int ditherSum = m_ditherError + 
+        (unsigned int) ((m_currentBrightness - brightness) * 256);
+    brightness += ditherSum >> 8;
+    m_ditherError = ditherSum & 0xFF;
+  }
+
+  if (m_ledPinNumber != NO_LED_PIN) {
+    brightness = limitBrightness(brightness);
+  }
+
+  if (m_pwmResolution > 8) {
+    writeTimer1Brightness(brightness);
+  } else if (m_ledPinNumber != NO_LED_PIN) {
+    analogWrite(m_ledPinNumber, brightness);
+  }
+
+  if (s_writeObserver != NULL && m_ledPinNumber != NO_LED_PIN) {
+    s_writeObserver(m_ledPinNumber, brightness);
+  }
+}
+
+unsigned int AnalogLed::limitBrightness(unsigned int brightness) {
+  unsigned int litBrightness = brightness;
+  unsigned long current;
+
+  if (m_ledType == COMMON_ANODE) {
+    litBrightness = m_brightnessTop - brightness;
+  }
+
+  // Replace this LED's share of the total with its new estimated 
+  // current (in 1/256 mA), so the total never has to be summed again.
+  current = ((unsigned long) litBrightness * m_currentFactor) >> 8;
+  s_totalCurrent = s_totalCurrent - m_budgetCurrent + current;
+  m_budgetCurrent = current;
+  updateBudgetScale();
+  m_budgetScale = s_budgetScale;
+
+  if (s_budgetScale < 256) {
+    litBrightness = ((unsigned long) litBrightness * s_budgetScale) >> 8;
+  }
+
   if (m_ledType == COMMON_ANODE) {
-    brightnessChange = (m_minBrightness -  m_maxBrightness) / 
-                       (float) minToMaxBrightnessInterval *
-                       deltaMillis * m_direction;  
+    brightness = m_brightnessTop - litBrightness;
+  } else {
+    brightness = litBrightness;
+  }
+
+  return brightness;
+}
+
+void AnalogLed::removeBudgetCurrent() {
+  // The other LEDs are scaled by the new total from their next write.
+  if (m_budgetCurrent > 0) {
+    s_totalCurrent -= m_budgetCurrent;
+    m_budgetCurrent = 0;
+    updateBudgetScale();
+  }
+}
+
+void AnalogLed::updateBudgetScale() {
+  if (s_currentBudget > 0 && s_totalCurrent > s_currentBudget) {
+    s_budgetScale = (s_currentBudget << 8) / s_totalCurrent;
+  } else {
+    s_budgetScale = 256;
+  }
+}
+
+void AnalogLed::followBrightnessLevel(float brightnessLevel) {
+  m_currentBrightness = m_minBrightness + 
+                        ((float) m_maxBrightness - m_minBrightness) * 
+                        brightnessLevel;
+  writeBrightness();
+}
+
+void AnalogLed::followBrightnessChange(unsigned long changeInterval) {
+  long fromBrightness = m_minBrightness;
+  long toBrightness = m_maxBrightness;
+  unsigned long brightnessSpan;
+  unsigned long changeOffset;
+  long fixedBrightness;
+
+  // A common cathode LED fades in with a positive direction and a 
+  // common anode LED with a negative one.
+  if ((m_direction == POSITIVE) != (m_ledType == COMMON_CATHODE)) {
+    fromBrightness = m_maxBrightness;
+    toBrightness = m_minBrightness;
+  }
+
+  if (toBrightness >= fromBrightness) {
+    brightnessSpan = toBrightness - fromBrightness;
+  } else {
+    brightnessSpan = fromBrightness - toBrightness;
+  }
+
+  // The brightness is calculated from the timer in 1/256 steps, so it
+  // doesn't drift, and its fraction is exact for dithering. The timer
+  // is at most the interval here, so the product fits in 32 bits.
+  changeOffset = (calculateChangeRate(brightnessSpan, changeInterval) *
+                  m_brightnessChangeTimer) >> 8;
+
+  if (toBrightness >= fromBrightness) {
+    fixedBrightness = fromBrightness * 256 + (long) changeOffset;
+  } else {
+    fixedBrightness = fromBrightness * 256 - (long) changeOffset;
+  }
+
+  m_currentBrightness = fixedBrightness / 256.0;
+  writeBrightness();
+}
+
+void AnalogLed::writeTimer1Brightness(unsigned int brightness) {
+  byte outputCompareBit = _BV(COM1B1);
+
+  if (m_ledPinNumber == 9) {
+    outputCompareBit = _BV(COM1A1);
+  }
+
+  // Fast PWM still outputs a one cycle pulse when the compare value is
+  // 0, so disconnect the pin from the timer to turn the LED fully off.
+  if (brightness == 0) {
+    TCCR1A &= ~outputCompareBit;
+  } else {
+    if (m_ledPinNumber == 9) {
+      OCR1A = brightness;
+    } else {
+      OCR1B = brightness;
+    }
+
+    TCCR1A |= outputCompareBit;
+  }
+}
+
+float AnalogLed::calculateBrightnessLevel() const {
+  float brightnessLevel = 0;
+
+  if (m_maxBrightness != m_minBrightness) {
+    brightnessLevel = (m_currentBrightness - m_minBrightness) /
+                      ((float) m_maxBrightness - m_minBrightness);
+  }
+
+  if (brightnessLevel < 0) {
+    brightnessLevel = 0;
+  } else if (brightnessLevel > 1) {
+    brightnessLevel = 1;
+  }
+
+  return brightnessLevel;
+}
+
+unsigned long AnalogLed::calculateChangeRate(unsigned long brightnessSpan,
+                                    unsigned long changeInterval) {
+  unsigned long changeRate = 0L;
+
+  if (changeInterval > 0) {
+    changeRate = (brightnessSpan << 16) / changeInterval;
   }
 
-  return brightnessChange;
+  return changeRate;
 }
\ No newline at end of file
@@ -9,7 +9,7 @@
  * loop.
  * 
  * @author Janette H. Griggs
- * @version 1.4 04/09/14
+ * @version 1.23 10/19/26
  */
 
 #ifndef AnalogLed_h
@@ -27,9 +27,22 @@
 #ifndef BrightnessChangeMode_h
   #include "BrightnessChangeMode.h"
 #endif
+#ifndef LedSnapshot_h
+  #include <LedSnapshot.h>
+#endif
 
 class AnalogLed {
   public:
+    static const byte DEFAULT_LED_CURRENT = 20; /**< current (mA) of an
+                                                LED at full brightness,
+                                                unless set */
+
+    /**
+     * Function called with the pin number and value of each write to
+     * an LED pin.
+     */
+    typedef void (*WriteObserver)(int pinNumber, unsigned int value);
+
     /**
      * Constructor.
      * Configures the LED light for analog (PWM) output.
@@ -100,6 +113,52 @@ class AnalogLed {
      */
     BrightnessChangeMode getBrightnessChangeMode() const;
 
+    /**
+     * Returns the dithering state of the LED.
+     * @return The dithering state.
+     */
+    bool getIsDitheringState() const;
+
+    /**
+     * Returns the PWM resolution (in bits) of the LED.
+     * @return The PWM resolution.
+     */
+    byte getPwmResolution() const;
+
+    /**
+     * Returns the seamless transition state of the LED.
+     * @return The seamless transition state.
+     */
+    bool getIsSeamlessTransitionState() const;
+
+    /**
+     * Returns the number of blink or fade steps that were late, i.e. 
+     * the timer was past the interval when the step was taken, e.g. 
+     * because the loop is slow or stalled. Stops counting at 65535.
+     * @return The late update count.
+     */
+    unsigned int getLateUpdateCount() const;
+
+    /**
+     * Returns the total time (in ms) by which blink or fade steps were
+     * late and that was dropped instead of carried to the next step.
+     * @return The lost remainder time.
+     */
+    unsigned long getLostRemainderTime() const;
+
+    /**
+     * Returns the most time (in ms) by which a blink or fade step was
+     * late.
+     * @return The maximum overshoot.
+     */
+    unsigned long getMaxOvershoot() const;
+
+    /**
+     * Returns the remainder carrying state of the LED.
+     * @return The remainder carrying state.
+     */
+    bool getIsCarryingRemainderState() const;
+
     /**
      * Sets the LED pin number.
      * @param The LED pin number.
@@ -118,6 +177,115 @@ class AnalogLed {
      */
     void setMaxBrightness(int maxBrightness);
 
+    /**
+     * Turns temporal dithering on or off. When dithering, the fractional
+     * part of the calculated brightness is carried from one loop to the
+     * next, so slow fades at low brightness change smoothly instead of
+     * stepping between whole PWM values.
+     * NOTE: Dithering works best when the loop runs at least as often
+     * as the PWM frequency (about every 2 ms).
+     * @param isDithering The dithering state.
+     */
+    void setDithering(bool isDithering);
+
+    /**
+     * Sets the PWM resolution of the LED. On pins 9 and 10, a resolution
+     * of 9 to 15 bits configures Timer1 for fast PWM with ICR1 as TOP
+     * and writes OCR1A/OCR1B directly instead of calling analogWrite().
+     * Any other pin or resolution uses the standard 8-bit analogWrite().
+     * The resolution stops at 15 bits, the most an int brightness value
+     * can hold.
+     * The minimum, maximum and current brightness values are rescaled,
+     * and from then on brightness values range from 0 to 
+     * 2^pwmResolution - 1.
+     * NOTE: Pins 9 and 10 share Timer1, so an LED on the other pin must
+     * use the same resolution. Timer1 is also used by the Servo library.
+     * @param pwmResolution The PWM resolution (in bits).
+     */
+    void setPwmResolution(byte pwmResolution);
+
+    /**
+     * Turns seamless transitions on or off. When on, switching to a
+     * fading mode continues from the current brightness, with the
+     * remaining fade time scaled to the remaining brightness range,
+     * instead of restarting at the minimum or maximum brightness.
+     * Switching to blinking starts from whichever of the minimum or
+     * maximum brightness is nearest to the current brightness.
+     * @param isSeamlessTransition The seamless transition state.
+     */
+    void setSeamlessTransition(bool isSeamlessTransition);
+
+    /**
+     * Turns remainder carrying on or off. When on, the time by which a
+     * blink or fade step was late is carried into the next step instead
+     * of being dropped, so the blink or fade period stays accurate on
+     * average when the loop is slow. Whole intervals that were skipped
+     * are still dropped.
+     * @param isCarryingRemainder The remainder carrying state.
+     */
+    void setCarryingRemainder(bool isCarryingRemainder);
+
+    /**
+     * Returns the function called after every write to the pin of any
+     * AnalogLed, e.g. to call it from another observer.
+     * @return The write observer, or NULL for none.
+     */
+    static WriteObserver getWriteObserver();
+
+    /**
+     * Sets a function to be called after every write to the pin of any
+     * AnalogLed, e.g. PinTrace::recordAnalogWrite() to trace the LED
+     * output. The value is the brightness actually written, after
+     * dithering.
+     * @param writeObserver The write observer, or NULL for none.
+     */
+    static void setWriteObserver(WriteObserver writeObserver);
+
+    /**
+     * Returns the current (in mA) the LED draws at full brightness.
+     * @return The LED current.
+     */
+    byte getLedCurrent() const;
+
+    /**
+     * Sets the current (in mA) the LED draws at full brightness, used
+     * to estimate the total current for the current budget.
+     * @param ledCurrent The LED current.
+     */
+    void setLedCurrent(byte ledCurrent);
+
+    /**
+     * Returns the estimated current (in mA) of all LEDs at the 
+     * brightness they were last set to, before the current budget 
+     * scales them down.
+     * @return The total current.
+     */
+    static unsigned int getTotalCurrent();
+
+    /**
+     * Returns the factor (in 1/256) by which the current budget scales
+     * the brightness of all LEDs, where 256 is no scaling.
+     * @return The budget scale.
+     */
+    static unsigned int getBudgetScale();
+
+    /**
+     * Sets a budget for the total current of all LEDs, e.g. to keep a
+     * supply from sagging when many LEDs are at full brightness. Each
+     * write adds the change in the estimated current of its LED to a
+     * running total, whether or not a budget is set, so the scale is
+     * right as soon as the budget is set. While the total is over the 
+     * budget, every LED is written at the brightness scaled by 
+     * budget / total.
+     * NOTE: LEDs written earlier in a loop use the scale from before
+     * the later writes, so the budget can be exceeded for one loop.
+     * An LED that doesn't change, e.g. while blinking, is rewritten 
+     * at its next update once the scale has changed, so only LEDs that
+     * are no longer updated keep their old output.
+     * @param currentBudget The current budget (in mA), or 0 for none.
+     */
+    static void setCurrentBudget(unsigned int currentBudget);
+
     /**
      * Turns on the LED and stops any blinking or fading activity.
      * NOTE: Call this function during each loop to maintain steady 
@@ -173,9 +341,39 @@ class AnalogLed {
     void showFadingInOutLed(unsigned long deltaMillis,
                        unsigned long fadeInterval);
 
+    /**
+     * Saves the brightness change mode, direction, timers and current 
+     * brightness of the LED, e.g. to store in EEPROM with 
+     * LedSnapshotStore. The state is copied with interrupts off, so 
+     * the snapshot is consistent even if the LED is updated from an 
+     * interrupt. Interrupts are off while 15 bytes are copied, an 
+     * estimated 70 cycles (not measured).
+     * @param snapshot The snapshot to save into.
+     */
+    void saveSnapshot(LedSnapshot& snapshot) const;
+
+    /**
+     * Restores the LED from a snapshot and writes the restored 
+     * brightness, so calling the same show function as before the
+     * snapshot resumes blinking or fading in phase. An animation is 
+     * not part of the snapshot and starts over. The state is restored
+     * with interrupts off.
+     * NOTE: The LED must have the same minimum and maximum brightness,
+     * LED type and PWM resolution as when the snapshot was saved.
+     * @param snapshot The snapshot to restore from.
+     */
+    void restoreSnapshot(const LedSnapshot& snapshot);
+
+    /**
+     * Sets the late update count, lost remainder time and maximum 
+     * overshoot to 0.
+     */
+    void resetTelemetry();
+
     /**
      * Sets the LED to its minimum brightness and sets it to an inactive 
-     * state. The active timer is set to 0.
+     * state. The active timer is set to 0. The LED's share is removed
+     * from the total current until the LED is written again.
      * NOTE: Call this function to terminate LED activity
      * and set the LED back to its initial state.
      */
@@ -186,12 +384,30 @@ class AnalogLed {
      */
     ~AnalogLed();
   private:
+    friend class AnalogLedGroup;
+    friend class AnalogLedBatch;
+    friend class AnimationPlayer;
+
+    static const int NO_LED_PIN = -1; /**< pin number of an LED without
+                                      output */
+
+    static WriteObserver s_writeObserver; /**< observer of LED pin writes */
+    static unsigned long s_currentBudget; /**< current budget (1/256 
+                                          mA) */
+    static unsigned long s_totalCurrent; /**< estimated current (1/256
+                                         mA) of all LEDs */
+    static unsigned int s_budgetScale; /**< brightness scale (1/256) of 
+                                       all LEDs */
+
     enum Direction {NEGATIVE = -1, ZERO = 0, POSITIVE = 1}; /**< direction 
                                                             enum */
 
     int m_ledPinNumber; /**< LED pin number */
     int m_minBrightness; /**< LED min brightness */
     int m_maxBrightness; /**< LED max brightness */
+    unsigned int m_brightnessTop; /**< highest brightness value of the PWM
+                                  resolution */
+    byte m_pwmResolution; /**< PWM resolution (bits) */
     float m_currentBrightness; /**< LED current brightness */
     unsigned long m_brightnessChangeTimer; /**< time (ms) since last brightness
                                        change */
@@ -200,15 +416,47 @@ class AnalogLed {
     LedType m_ledType; /**< LED type */
     BrightnessChangeMode m_brightnessChangeMode; /**< brightness change mode */
     Direction m_direction; /**< direction of brightness change*/
+    bool m_isDithering; /**< dithering state of LED */
+    byte m_ditherError; /**< brightness fraction (1/256) carried over to
+                        the next write */
+    bool m_isSeamlessTransition; /**< seamless transition state of LED */
+    bool m_isCarryingRemainder; /**< remainder carrying state of LED */
+    unsigned int m_lateUpdateCount; /**< number of steps that were 
+                                    late */
+    unsigned long m_lostRemainderTime; /**< time (ms) dropped from late 
+                                       steps */
+    unsigned long m_maxOvershoot; /**< most time (ms) a step was late */
+    byte m_ledCurrent; /**< current (mA) at full brightness */
+    unsigned long m_currentFactor; /**< estimated current (1/65536 mA) 
+                                   per brightness step */
+    unsigned long m_budgetCurrent; /**< estimated current (1/256 mA) in
+                                   the total */
+    unsigned int m_budgetScale; /**< budget scale of the last write */
+
+    /**
+     * Constructor.
+     * Creates an LED without output, which only calculates the 
+     * brightness between 0 and 255. Used by AnalogLedGroup to run one
+     * animation for all of its LEDs.
+     */
+    AnalogLed();
 
     /**
      * Stops blinking or fading the LED.
      */
     void stopChangingBrightness();
 
+    /**
+     * Restarts the brightness change timer at the end of a blink or fade
+     * interval, recording how late the step was and carrying the 
+     * remainder if enabled.
+     */
+    void restartBrightnessChange(unsigned long changeInterval);
+
     /**
      * Activates the LED. Increments the active
-     * timer during each loop.
+     * timer during each loop, and rewrites the LED if the budget scale
+     * has changed since its last write.
      */
     void activateLed(unsigned long deltaMillis);
 
@@ -223,10 +471,58 @@ class AnalogLed {
     void setToMinBrightness();
 
     /**
-     * Calculates the brightness change amount.
+     * Writes the current brightness to the LED pin, dithering the
+     * fractional part if enabled.
+     */
+    void writeBrightness();
+
+    /**
+     * Sets the LED to a brightness level between its minimum (0.0)
+     * and maximum (1.0) brightness and writes it to the LED pin.
+     */
+    void followBrightnessLevel(float brightnessLevel);
+
+    /**
+     * Sets the LED to the brightness of a fade at the brightness 
+     * change timer and writes it to the LED pin.
+     */
+    void followBrightnessChange(unsigned long changeInterval);
+
+    /**
+     * Writes the brightness to the Timer1 output compare register
+     * of the LED pin.
+     */
+    void writeTimer1Brightness(unsigned int brightness);
+
+    /**
+     * Updates the total current with the brightness of the LED and 
+     * returns the brightness scaled to the current budget.
+     */
+    unsigned int limitBrightness(unsigned int brightness);
+
+    /**
+     * Removes the LED's share from the total current.
+     */
+    void removeBudgetCurrent();
+
+    /**
+     * Calculates the brightness scale from the total current and the 
+     * current budget.
+     */
+    static void updateBudgetScale();
+
+    /**
+     * Calculates the current brightness as a level between the minimum
+     * (0.0) and maximum (1.0) brightness.
+     */
+    float calculateBrightnessLevel() const;
+
+    /**
+     * Calculates the brightness change per ms (in 1/65536 steps) over a
+     * fade interval.
      */
-    float calculateBrightnessChange(unsigned long deltaMillis,
-                                    unsigned long minToMaxBrightnessInterval);
+    static unsigned long calculateChangeRate(unsigned long brightnessSpan,
+                                             unsigned long changeInterval);
 };
 
 #endif
\ No newline at end of file
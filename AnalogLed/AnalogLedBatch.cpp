@@ -0,0 +1,126 @@
+// Function definitions for the AnalogLedBatch class.
+
+// @author Janette H. Griggs
+// @version 1.1 10/19/26
+
+#include "AnalogLedBatch.h"
+
+AnalogLedBatch::AnalogLedBatch(uint32_t timers[], byte fadingIn[],
+                               unsigned int outputs[],
+                               unsigned int ledCount,
+                               int minBrightness, int maxBrightness,
+                               LedType ledType) {
+  m_timers = timers;
+  m_fadingIn = fadingIn;
+  m_outputs = outputs;
+  m_ledCount = ledCount;
+  m_ledType = ledType;
+  m_fadeInterval = 0L;
+
+  // The brightness is kept as the duty cycle, as AnalogLed does.
+  if (m_ledType == COMMON_ANODE) {
+    m_minBrightness = 255 - minBrightness;
+    m_maxBrightness = 255 - maxBrightness;
+  } else {
+    m_minBrightness = minBrightness;
+    m_maxBrightness = maxBrightness;
+  }
+
+  startFadingInOut();
+}
+
+unsigned int AnalogLedBatch::getLedCount() const {
+  return m_ledCount;
+}
+
+unsigned int AnalogLedBatch::getBrightness(unsigned int index) const {
+  return m_outputs[index];
+}
+
+void AnalogLedBatch::startFadingInOut() {
+  for (unsigned int i = 0; i < m_ledCount; i++) {
+    m_timers[i] = 0;
+    m_fadingIn[i] = 1;
+    m_outputs[i] = m_minBrightness;
+  }
+}
+
+void AnalogLedBatch::loadLed(unsigned int index, const AnalogLed& led) {
+  m_timers[index] = led.m_brightnessChangeTimer;
+  m_fadingIn[index] = (led.m_direction == AnalogLed::POSITIVE) ==
+                      (led.m_ledType == COMMON_CATHODE);
+
+  if (led.m_currentBrightness > 0) {
+    m_outputs[index] = (unsigned int) led.m_currentBrightness;
+  } else {
+    m_outputs[index] = 0;
+  }
+}
+
+void AnalogLedBatch::storeLed(unsigned int index, AnalogLed& led) const {
+  led.m_brightnessChangeTimer = m_timers[index];
+  led.m_brightnessChangeMode = FADE_IN_OUT;
+
+  if ((m_fadingIn[index] == 1) == (m_ledType == COMMON_CATHODE)) {
+    led.m_direction = AnalogLed::POSITIVE;
+  } else {
+    led.m_direction = AnalogLed::NEGATIVE;
+  }
+
+  led.followBrightnessChange(m_fadeInterval);
+}
+
+void AnalogLedBatch::updateFadingInOut(unsigned long deltaMillis,
+                                       unsigned long fadeInterval) {
+  // The same rate and 1/256 steps as AnalogLed::followBrightnessChange(),
+  // which fades from the minimum brightness while fading in and from 
+  // the maximum brightness while fading out.
+  uint32_t brightnessSpan;
+  uint32_t changeRate;
+  uint32_t fadeInStart = (uint32_t) m_minBrightness << 8;
+  uint32_t fadeOutStart = (uint32_t) m_maxBrightness << 8;
+  byte isMaxHigher = m_maxBrightness >= m_minBrightness;
+  uint32_t interval = fadeInterval;
+  uint32_t delta = deltaMillis;
+  uint32_t* timers = m_timers;
+  byte* fadingIn = m_fadingIn;
+  unsigned int* outputs = m_outputs;
+  unsigned int ledCount = m_ledCount;
+
+  if (isMaxHigher) {
+    brightnessSpan = m_maxBrightness - m_minBrightness;
+  } else {
+    brightnessSpan = m_minBrightness - m_maxBrightness;
+  }
+
+  changeRate = AnalogLed::calculateChangeRate(brightnessSpan, fadeInterval);
+  m_fadeInterval = fadeInterval;
+
+  // Each LED is advanced with conditional assignments instead of
+  // branches, so the loop can be vectorized. The arrays and count are
+  // copied to locals, since a store through an array could otherwise
+  // change the count as far as the compiler knows. A turning LED 
+  // starts the other direction with its timer at 0, which gives the 
+  // brightness it turned at. Otherwise the timer is less than the 
+  // interval, so the product fits in 32 bits.
+  for (unsigned int i = 0; i < ledCount; i++) {
+    uint32_t timer = timers[i] + delta;
+    byte isTurning = timer >= interval;
+    byte isFadingIn = fadingIn[i] ^ isTurning;
+    uint32_t changeOffset;
+    uint32_t fadeStart = isFadingIn ? fadeInStart : fadeOutStart;
+    uint32_t fixedBrightness;
+
+    timer = isTurning ? 0 : timer;
+    changeOffset = (changeRate * timer) >> 8;
+    fixedBrightness = isFadingIn == isMaxHigher ?
+                      fadeStart + changeOffset : fadeStart - changeOffset;
+    timers[i] = timer;
+    fadingIn[i] = isFadingIn;
+    outputs[i] = fixedBrightness >> 8;
+  }
+}
+
+AnalogLedBatch::~AnalogLedBatch() {
+
+}
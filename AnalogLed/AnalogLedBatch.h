@@ -0,0 +1,142 @@
+/**
+ * AnalogLedBatch class.
+ *
+ * This class fades many LEDs in and out at once, e.g. to simulate the
+ * LEDs of a large installation on a host computer. The state of the 
+ * LEDs is kept in structure-of-arrays form, with one array per field,
+ * and each update runs one loop of 32-bit integer math over the arrays
+ * with no branches and no calls, so a compiler can vectorize it and 
+ * falls back to a scalar loop otherwise. The fade rate is calculated
+ * once per update instead of once per LED.
+ *
+ * The brightness of each LED is calculated from its fade timer in 
+ * fixed-point 1/256 steps, with the same rate as 
+ * AnalogLed::showFadingInOutLed(), so the results are bit-identical to
+ * calling it for each LED, for 8-bit LEDs with the minimum and maximum
+ * brightness and LED type of the batch, without dithering, remainder
+ * carrying or a current budget. The LED pins are not written: the 
+ * brightness each LED would write is kept in the output array. Active
+ * timers and late update telemetry are not updated.
+ *
+ * Example:
+ *   uint32_t timers[1000];
+ *   byte fadingIn[1000];
+ *   unsigned int outputs[1000];
+ *   AnalogLedBatch batch(timers, fadingIn, outputs, 1000, 0, 255,
+ *                        COMMON_ANODE);
+ *   batch.startFadingInOut();
+ *   // For each step: batch.updateFadingInOut(deltaMillis, 1000);
+ *
+ * @author Janette H. Griggs
+ * @version 1.1 10/19/26
+ */
+
+#ifndef AnalogLedBatch_h
+  #define AnalogLedBatch_h
+
+#ifndef __AVR_ATmega328P__
+  #define __AVR_ATmega328P__
+#endif
+#ifndef Arduino_h
+  #include <Arduino.h>
+#endif
+#ifndef AnalogLed_h
+  #include "AnalogLed.h"
+#endif
+
+class AnalogLedBatch {
+  public:
+    /**
+     * Constructor.
+     * The arrays must each hold ledCount values and exist for as long
+     * as the batch does.
+     * @param timers The array of fade timers (ms). They are 32 bits,
+     * as an unsigned long is on the Arduino, so the loop can use 32-bit
+     * lanes on a host computer too.
+     * @param fadingIn The array of fade directions, 1 while fading in 
+     * and 0 while fading out. They are bytes, since a bool array keeps
+     * GCC from vectorizing the loop.
+     * @param outputs The array of brightness values the LEDs would
+     * write.
+     * @param ledCount The number of LEDs in the batch.
+     * @param minBrightness The minimum brightness of all LEDs.
+     * @param maxBrightness The maximum brightness of all LEDs.
+     * @param ledType The LED type of all LEDs. This is one of the enum 
+     * values: COMMON_CATHODE, COMMON_ANODE.
+     */
+    AnalogLedBatch(uint32_t timers[], byte fadingIn[],
+                   unsigned int outputs[], unsigned int ledCount,
+                   int minBrightness, int maxBrightness,
+                   LedType ledType = COMMON_CATHODE);
+
+    /**
+     * Returns the number of LEDs in the batch.
+     * @return The number of LEDs.
+     */
+    unsigned int getLedCount() const;
+
+    /**
+     * Returns the brightness an LED would write after the last update.
+     * @param index The index of the LED in the batch.
+     * @return The brightness.
+     */
+    unsigned int getBrightness(unsigned int index) const;
+
+    /**
+     * Starts fading all LEDs in from the minimum brightness, as the
+     * first call of AnalogLed::showFadingInOutLed() does without
+     * seamless transitions.
+     */
+    void startFadingInOut();
+
+    /**
+     * Copies the fading state of an LED into the batch, e.g. to
+     * continue an LED that was already fading.
+     * NOTE: The LED must be fading in and out, with the minimum and 
+     * maximum brightness and LED type of the batch.
+     * @param index The index of the LED in the batch.
+     * @param led The LED.
+     */
+    void loadLed(unsigned int index, const AnalogLed& led);
+
+    /**
+     * Copies the fading state of an LED in the batch back into an LED
+     * and writes its brightness, so the LED continues from there. The
+     * brightness is calculated with the fade interval of the last
+     * update.
+     * @param index The index of the LED in the batch.
+     * @param led The LED.
+     */
+    void storeLed(unsigned int index, AnalogLed& led) const;
+
+    /**
+     * Fades all LEDs in and out by one update, as a call of
+     * AnalogLed::showFadingInOutLed() does for each LED.
+     * @param deltaMillis The change in time (ms) from the previous
+     * update.
+     * @param fadeInterval The interval (in ms) between minimum and
+     * maximum brightness.
+     */
+    void updateFadingInOut(unsigned long deltaMillis,
+                           unsigned long fadeInterval);
+
+    /**
+     * Destructor.
+     */
+    ~AnalogLedBatch();
+  private:
+    uint32_t* m_timers; /**< fade timer (ms) of each LED */
+    byte* m_fadingIn; /**< fade direction of each LED, 1 while fading 
+                      in */
+    unsigned int* m_outputs; /**< brightness each LED would write */
+    unsigned int m_ledCount; /**< number of LEDs */
+    unsigned int m_minBrightness; /**< minimum brightness (duty) of all 
+                                  LEDs */
+    unsigned int m_maxBrightness; /**< maximum brightness (duty) of all
+                                  LEDs */
+    LedType m_ledType; /**< LED type of all LEDs */
+    unsigned long m_fadeInterval; /**< fade interval (ms) of the last 
+                                  update */
+};
+
+#endif
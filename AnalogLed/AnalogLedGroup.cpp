@@ -0,0 +1,76 @@
+// Function definitions for the AnalogLedGroup class.
+
+// @author Janette H. Griggs
+// @version 1.1 10/19/26
+
+#include "AnalogLedGroup.h"
+
+AnalogLedGroup::AnalogLedGroup(AnalogLed* leds[], byte ledCount) {
+  m_leds = leds;
+  m_ledCount = ledCount;
+}
+
+byte AnalogLedGroup::getLedCount() const {
+  return m_ledCount;
+}
+
+unsigned long AnalogLedGroup::getGroupActiveTimer() const {
+  return m_animation.getActiveTimer();
+}
+
+BrightnessChangeMode AnalogLedGroup::getGroupBrightnessChangeMode() const {
+  return m_animation.getBrightnessChangeMode();
+}
+
+void AnalogLedGroup::setGroupSeamlessTransition(bool isSeamlessTransition) {
+  m_animation.setSeamlessTransition(isSeamlessTransition);
+}
+
+void AnalogLedGroup::showSteadyLedGroup(unsigned long deltaMillis) {
+  m_animation.showSteadyLed(deltaMillis);
+  showLeds();
+}
+
+void AnalogLedGroup::showBlinkingLedGroup(unsigned long deltaMillis,
+                                          unsigned long blinkInterval) {
+  m_animation.showBlinkingLed(deltaMillis, blinkInterval);
+  showLeds();
+}
+
+void AnalogLedGroup::showFadingInLedGroup(unsigned long deltaMillis,
+                                          unsigned long fadeInterval) {
+  m_animation.showFadingInLed(deltaMillis, fadeInterval);
+  showLeds();
+}
+
+void AnalogLedGroup::showFadingOutLedGroup(unsigned long deltaMillis,
+                                           unsigned long fadeInterval) {
+  m_animation.showFadingOutLed(deltaMillis, fadeInterval);
+  showLeds();
+}
+
+void AnalogLedGroup::showFadingInOutLedGroup(unsigned long deltaMillis,
+                                             unsigned long fadeInterval) {
+  m_animation.showFadingInOutLed(deltaMillis, fadeInterval);
+  showLeds();
+}
+
+void AnalogLedGroup::resetLedGroup() {
+  m_animation.resetLed();
+
+  for (byte i = 0; i < m_ledCount; i++) {
+    m_leds[i]->resetLed();
+  }
+}
+
+AnalogLedGroup::~AnalogLedGroup() {
+
+}
+
+void AnalogLedGroup::showLeds() {
+  float brightnessLevel = m_animation.getCurrentBrightness() / 255;
+
+  for (byte i = 0; i < m_ledCount; i++) {
+    m_leds[i]->followBrightnessLevel(brightnessLevel);
+  }
+}
@@ -0,0 +1,144 @@
+/**
+ * AnalogLedGroup class.
+ *
+ * This class runs one blinking or fading animation for a group of
+ * AnalogLed lights. The brightness is calculated once per loop and
+ * then scaled to the minimum and maximum brightness (and LED type) of 
+ * each LED in the group, so all LEDs stay in phase and each loop costs
+ * one brightness calculation plus one write per LED.
+ *
+ * The LEDs in the group are only written to. Their own brightness
+ * change modes and timers are not used while the group drives them.
+ *
+ * @author Janette H. Griggs
+ * @version 1.1 10/19/26
+ */
+
+#ifndef AnalogLedGroup_h
+  #define AnalogLedGroup_h
+
+#ifndef __AVR_ATmega328P__
+  #define __AVR_ATmega328P__
+#endif
+#ifndef Arduino_h
+  #include <Arduino.h>
+#endif
+#ifndef AnalogLed_h
+  #include "AnalogLed.h"
+#endif
+
+class AnalogLedGroup {
+  public:
+    /**
+     * Constructor.
+     * @param leds The array of LEDs in the group. The array must
+     * exist for as long as the group does.
+     * @param ledCount The number of LEDs in the array.
+     */
+    AnalogLedGroup(AnalogLed* leds[], byte ledCount);
+
+    /**
+     * Returns the number of LEDs in the group.
+     * @return The number of LEDs.
+     */
+    byte getLedCount() const;
+
+    /**
+     * Returns the time (in ms) since the group was active.
+     * @return The active timer.
+     */
+    unsigned long getGroupActiveTimer() const;
+
+    /**
+     * Returns the brightness change mode of the group.
+     * @return The brightness change mode.
+     */
+    BrightnessChangeMode getGroupBrightnessChangeMode() const;
+
+    /**
+     * Turns seamless transitions between brightness change modes on or
+     * off for the group.
+     * @param isSeamlessTransition The seamless transition state.
+     */
+    void setGroupSeamlessTransition(bool isSeamlessTransition);
+
+    /**
+     * Turns on the LEDs and stops any blinking or fading activity.
+     * NOTE: Call this function during each loop to maintain steady 
+     * LED activity.
+     * @param deltaMillis The change in time (ms) from the previous loop. 
+     */
+    void showSteadyLedGroup(unsigned long deltaMillis);
+
+    /**
+     * Blinks the LEDs based on the specified interval.
+     * NOTE: Call this function during each loop to maintain blinking 
+     * LED activity.
+     * @param deltaMillis The change in time (ms) from the previous loop.
+     * @param blinkInterval The interval (in ms) between the maximum 
+     * brightness and minumum brightness.
+     */
+    void showBlinkingLedGroup(unsigned long deltaMillis,
+                              unsigned long blinkInterval);
+
+    /**
+     * Fades in the LEDs in a repeating loop based on the specified 
+     * interval.
+     * NOTE: Call this function during each loop to maintain fading
+     * LED activity.
+     * @param deltaMillis The change in time (ms) from the previous loop.
+     * @param fadeInterval The interval (in ms) between the maximum 
+     * brightness and minumum brightness.
+     */
+    void showFadingInLedGroup(unsigned long deltaMillis,
+                              unsigned long fadeInterval);
+
+    /**
+     * Fades out the LEDs in a repeating loop based on the specified 
+     * interval.
+     * NOTE: Call this function during each loop to maintain fading
+     * LED activity.
+     * @param deltaMillis The change in time (ms) from the previous loop.
+     * @param fadeInterval The interval (in ms) between the maximum 
+     * brightness and minumum brightness.
+     */
+    void showFadingOutLedGroup(unsigned long deltaMillis,
+                               unsigned long fadeInterval);
+
+    /**
+     * Fades the LEDs in and out repeatedly based on the specified
+     * interval.
+     * NOTE: Call this function during each loop to maintain fading
+     * LED activity.
+     * @param deltaMillis The change in time (ms) from the previous loop.
+     * @param fadeInterval The interval (in ms) between the maximum 
+     * brightness and minumum brightness.
+     */
+    void showFadingInOutLedGroup(unsigned long deltaMillis,
+                                 unsigned long fadeInterval);
+
+    /**
+     * Sets the LEDs to their minimum brightness and sets them to an
+     * inactive state. The active timer is set to 0.
+     * NOTE: Call this function to terminate LED activity
+     * and set the LEDs back to their initial state.
+     */
+    void resetLedGroup();
+
+    /**
+     * Destructor.
+     */
+    ~AnalogLedGroup();
+  private:
+    AnalogLed** m_leds; /**< LEDs in the group */
+    byte m_ledCount; /**< number of LEDs in the group */
+    AnalogLed m_animation; /**< LED without output that calculates the 
+                           brightness of the group */
+
+    /**
+     * Scales the calculated brightness of the group to each LED.
+     */
+    void showLeds();
+};
+
+#endif
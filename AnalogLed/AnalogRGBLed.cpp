@@ -1,9 +1,11 @@
 // Function definitions for AnalogRGBLed class.
 
 // @author Janette H. Griggs
-// @version 1.2 04/09/14
+// @version 1.7 10/19/26
 
 #include "AnalogRGBLed.h"
+#include <avr/eeprom.h>
+#include <util/crc16.h>
 
 AnalogRGBLed::AnalogRGBLed(
     int redPinNumber,
@@ -16,18 +18,57 @@ AnalogRGBLed::AnalogRGBLed(
     m_redLed(redPinNumber, 0, redBrightness, ledType),
     m_greenLed(greenPinNumber, 0, greenBrightness, ledType),
     m_blueLed(bluePinNumber, 0, blueBrightness, ledType) {
+  m_color[0] = redBrightness;
+  m_color[1] = greenBrightness;
+  m_color[2] = blueBrightness;
+  m_calibration = NULL;
 }
    
 unsigned long AnalogRGBLed::getRGBActiveTimer() const {
   return m_redLed.getActiveTimer();
 }
 
+const RGBCalibration* AnalogRGBLed::getRGBCalibration() const {
+  return m_calibration;
+}
+
+void AnalogRGBLed::setRGBCalibration(const RGBCalibration* calibration) {
+  m_calibration = calibration;
+  writeRGBColor();
+}
+
 void AnalogRGBLed::setRGBColor(int redBrightness,
                                int greenBrightness,
                                int blueBrightness) {
-  m_redLed.setMaxBrightness(redBrightness);
-  m_greenLed.setMaxBrightness(greenBrightness);
-  m_blueLed.setMaxBrightness(blueBrightness);
+  m_color[0] = redBrightness;
+  m_color[1] = greenBrightness;
+  m_color[2] = blueBrightness;
+  writeRGBColor();
+}
+
+void AnalogRGBLed::setRGBDithering(bool isDithering) {
+  m_redLed.setDithering(isDithering);
+  m_greenLed.setDithering(isDithering);
+  m_blueLed.setDithering(isDithering);
+}
+
+void AnalogRGBLed::setRGBLedCurrent(byte redCurrent, byte greenCurrent,
+                                    byte blueCurrent) {
+  m_redLed.setLedCurrent(redCurrent);
+  m_greenLed.setLedCurrent(greenCurrent);
+  m_blueLed.setLedCurrent(blueCurrent);
+}
+
+void AnalogRGBLed::setRGBSeamlessTransition(bool isSeamlessTransition) {
+  m_redLed.setSeamlessTransition(isSeamlessTransition);
+  m_greenLed.setSeamlessTransition(isSeamlessTransition);
+  m_blueLed.setSeamlessTransition(isSeamlessTransition);
+}
+
+void AnalogRGBLed::setRGBCarryingRemainder(bool isCarryingRemainder) {
+  m_redLed.setCarryingRemainder(isCarryingRemainder);
+  m_greenLed.setCarryingRemainder(isCarryingRemainder);
+  m_blueLed.setCarryingRemainder(isCarryingRemainder);
 }
 
 
@@ -72,6 +113,92 @@ void AnalogRGBLed::resetRGBLed() {
   m_blueLed.resetLed();
 }
 
+bool AnalogRGBLed::loadRGBCalibration(RGBCalibration& calibration,
+                                      unsigned int eepromAddress) {
+  RGBCalibration storedCalibration;
+  unsigned int storedCrc;
+  bool isValid;
+
+  eeprom_read_block(&storedCalibration, (const void*) eepromAddress,
+                    sizeof(storedCalibration));
+  eeprom_read_block(&storedCrc,
+                    (const void*) (eepromAddress + 
+                                   sizeof(storedCalibration)),
+                    sizeof(storedCrc));
+
+  isValid = calculateCalibrationCrc(storedCalibration) == storedCrc;
+
+  if (isValid) {
+    calibration = storedCalibration;
+  }
+
+  return isValid;
+}
+
+void AnalogRGBLed::saveRGBCalibration(const RGBCalibration& calibration,
+                                      unsigned int eepromAddress) {
+  unsigned int crc = calculateCalibrationCrc(calibration);
+
+  eeprom_update_block(&calibration, (void*) eepromAddress,
+                      sizeof(calibration));
+  eeprom_update_block(&crc, 
+                      (void*) (eepromAddress + sizeof(calibration)),
+                      sizeof(crc));
+}
+
+void AnalogRGBLed::writeRGBColor() {
+  m_redLed.setMaxBrightness(calibrateBrightness(0, m_color[0]));
+  m_greenLed.setMaxBrightness(calibrateBrightness(1, m_color[1]));
+  m_blueLed.setMaxBrightness(calibrateBrightness(2, m_color[2]));
+}
+
+int AnalogRGBLed::calibrateBrightness(byte channel, int brightness) const {
+  byte segment;
+  byte lowPoint;
+  byte highPoint;
+
+  if (m_calibration != NULL) {
+    if (brightness < 0) {
+      brightness = 0;
+    } else if (brightness > 255) {
+      brightness = 255;
+    }
+
+    // The curve points are 32 apart, except the last one, which is
+    // at 255 so the full brightness maps to it exactly.
+    if (m_calibration->isUsingCurves) {
+      if (brightness == 255) {
+        brightness = m_calibration->curves[channel]
+                         [RGBCalibration::CURVE_POINT_COUNT - 1];
+      } else {
+        segment = brightness >> 5;
+        lowPoint = m_calibration->curves[channel][segment];
+        highPoint = m_calibration->curves[channel][segment + 1];
+        brightness = lowPoint + 
+                     ((int) (highPoint - lowPoint) * (brightness & 31) + 
+                      16) / 32;
+      }
+    }
+
+    brightness = ((unsigned int) brightness * 
+                  m_calibration->gains[channel] + 127) / 255;
+  }
+
+  return brightness;
+}
+
+unsigned int AnalogRGBLed::calculateCalibrationCrc(
+    const RGBCalibration& calibration) {
+  const byte* data = (const byte*) &calibration;
+  unsigned int crc = 0xFFFF;
+
+  for (byte i = 0; i < sizeof(calibration); i++) {
+    crc = _crc16_update(crc, data[i]);
+  }
+
+  return crc;
+}
+
 AnalogRGBLed::~AnalogRGBLed() {
 
 }
\ No newline at end of file
@@ -6,8 +6,15 @@
  * blinking and fading for a common cathode or a common anode
  * RGB LED.
  *
+ * A calibration can be set to make fixtures from different batches 
+ * show the same color. Each color value is mapped through an optional
+ * curve and scaled by a gain for its channel when the color is set, so
+ * blinking and fading cost no more than without a calibration. 
+ * Calibrations can be stored in EEPROM with saveRGBCalibration() and
+ * loaded in setup() with loadRGBCalibration().
+ *
  * @author Janette H. Griggs
- * @version 1.2 04/09/14
+ * @version 1.7 10/19/26
  */
  
 #ifndef AnalogRGBLed_h
@@ -22,6 +29,9 @@
 #ifndef AnalogLed_h
   #include "AnalogLed.h"
 #endif
+#ifndef RGBCalibration_h
+  #include "RGBCalibration.h"
+#endif
 
 class AnalogRGBLed {
   
@@ -55,8 +65,23 @@ class AnalogRGBLed {
      */
     unsigned long getRGBActiveTimer() const;
 
+    /**
+     * Returns the color calibration.
+     * @return The calibration, or NULL if there is none.
+     */
+    const RGBCalibration* getRGBCalibration() const;
+
+    /**
+     * Sets the color calibration and applies it to the current color.
+     * @param calibration The calibration, or NULL for none. The 
+     * calibration must exist for as long as the LED does.
+     */
+    void setRGBCalibration(const RGBCalibration* calibration);
+
     /**
      * Sets the color of the RGB LED.
+     * With a calibration, the brightness values are calibrated once 
+     * here.
      * @param redBrightness The brightness value for the red color,
      * which is between 0 and 255, inclusive.
      * @param greenBrightness The brightness value for the green color,
@@ -67,6 +92,36 @@ class AnalogRGBLed {
     void setRGBColor(int redBrightness,
                      int greenBrightness,
                      int blueBrightness);
+
+    /**
+     * Turns temporal dithering on or off for all three colors.
+     * @param isDithering The dithering state.
+     */
+    void setRGBDithering(bool isDithering);
+
+    /**
+     * Sets the current (in mA) each color draws at full brightness, 
+     * used for the current budget of AnalogLed::setCurrentBudget().
+     * @param redCurrent The current of the red color.
+     * @param greenCurrent The current of the green color.
+     * @param blueCurrent The current of the blue color.
+     */
+    void setRGBLedCurrent(byte redCurrent, byte greenCurrent,
+                          byte blueCurrent);
+
+    /**
+     * Turns seamless transitions between brightness change modes on or
+     * off for all three colors.
+     * @param isSeamlessTransition The seamless transition state.
+     */
+    void setRGBSeamlessTransition(bool isSeamlessTransition);
+
+    /**
+     * Turns carrying of the time by which a blink or fade step was late
+     * on or off for all three colors.
+     * @param isCarryingRemainder The remainder carrying state.
+     */
+    void setRGBCarryingRemainder(bool isCarryingRemainder);
     
     /**
      * Turns on the LED and stops any blinking or fading activity.
@@ -130,6 +185,25 @@ class AnalogRGBLed {
      * and set the LED back to its initial state.
      */
     void resetRGBLed();
+
+    /**
+     * Loads a calibration from EEPROM.
+     * @param calibration The calibration to load into. It is only 
+     * changed if the stored calibration is valid.
+     * @param eepromAddress The EEPROM address of the calibration.
+     * @return The truth value of whether a valid calibration was found.
+     */
+    static bool loadRGBCalibration(RGBCalibration& calibration,
+                                   unsigned int eepromAddress);
+
+    /**
+     * Saves a calibration to EEPROM with a CRC, taking 
+     * sizeof(RGBCalibration) + 2 bytes.
+     * @param calibration The calibration.
+     * @param eepromAddress The EEPROM address of the calibration.
+     */
+    static void saveRGBCalibration(const RGBCalibration& calibration,
+                                   unsigned int eepromAddress);
     
     /**
      * Destructor.
@@ -139,6 +213,26 @@ class AnalogRGBLed {
     AnalogLed m_redLed; /**< red LED */
     AnalogLed m_greenLed; /**< green LED */
     AnalogLed m_blueLed; /**< blue LED */
+    int m_color[3]; /**< red, green and blue brightness before 
+                    calibration */
+    const RGBCalibration* m_calibration; /**< color calibration */
+
+    /**
+     * Sets the maximum brightness of each color from the color and 
+     * calibration.
+     */
+    void writeRGBColor();
+
+    /**
+     * Returns the calibrated brightness of a color channel.
+     */
+    int calibrateBrightness(byte channel, int brightness) const;
+
+    /**
+     * Returns the CRC of a calibration.
+     */
+    static unsigned int calculateCalibrationCrc(
+        const RGBCalibration& calibration);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,27 @@
+// RGBCalibration struct for the color calibration of an AnalogRGBLed.
+
+// @author Janette H. Griggs
+// @version 1.0 10/19/26
+
+#ifndef RGBCalibration_h
+  #define RGBCalibration_h
+
+#ifndef __AVR_ATmega328P__
+  #define __AVR_ATmega328P__
+#endif
+#ifndef Arduino_h
+  #include <Arduino.h>
+#endif
+
+struct RGBCalibration {
+  static const byte CURVE_POINT_COUNT = 9; /**< points in each curve */
+
+  byte gains[3]; /**< red, green and blue gain, where 255 is 1.0 */
+  bool isUsingCurves; /**< whether the curves are applied */
+  byte curves[3][CURVE_POINT_COUNT]; /**< red, green and blue 
+                                     brightness for a color value of 
+                                     0, 32, 64, ..., 224 and 255, with
+                                     linear steps in between */
+};
+
+#endif
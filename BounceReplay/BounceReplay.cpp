@@ -0,0 +1,266 @@
+// Function definitions for the BounceReplay class.
+
+// @author Janette H. Griggs
+// @version 1.1 10/19/26
+
+#include "BounceReplay.h"
+
+BounceReplay* BounceReplay::s_activeReplay = NULL;
+
+BounceReplay::BounceReplay(Print& output, unsigned long latencies[],
+                           unsigned int latencyCapacity) :
+    m_output(output) {
+  m_latencies = latencies;
+  m_latencyCapacity = latencyCapacity;
+  m_latencyCount = 0;
+  m_pushCount = 0;
+  m_missedPushCount = 0;
+  m_rejectedPushCount = 0;
+  m_buttonPinNumber = 0;
+  m_traceValue = LOW;
+  m_ledPinNumber = 0;
+  m_ledValue = 0;
+  m_isLedValueKnown = false;
+  m_replayTime = 0L;
+  m_pushStartTime = 0L;
+  m_isPushPending = false;
+  m_isPushLit = false;
+  m_previousReadFunction = NULL;
+  m_previousAnalogObserver = NULL;
+  m_previousDigitalObserver = NULL;
+}
+
+void BounceReplay::writeHeader() {
+  m_output.println("name,loop_ms,debounce_ms,pushes,missed,rejected,"
+                   "rejected_per_1000,p50_ms,p90_ms,p99_ms,max_ms");
+}
+
+void BounceReplay::run(const char* name, PushButton& button,
+                       int ledPinNumber, LoopFunction loopFunction,
+                       const PinTraceEvent events[],
+                       unsigned int eventCount, unsigned long loopPeriod,
+                       unsigned long debounceDelay) {
+  unsigned long rejectedPerThousand = 0L;
+
+  m_latencyCount = 0;
+  m_pushCount = 0;
+  m_missedPushCount = 0;
+  m_rejectedPushCount = 0;
+  m_ledPinNumber = ledPinNumber;
+
+  if (loopPeriod > 0) {
+    replayTrace(button, loopFunction, events, eventCount, loopPeriod,
+                debounceDelay);
+    sortLatencies();
+  }
+
+  if (m_pushCount + m_rejectedPushCount > 0) {
+    rejectedPerThousand = (unsigned long) m_rejectedPushCount * 1000 /
+                          (m_pushCount + m_rejectedPushCount);
+  }
+
+  m_output.print(name);
+  m_output.print(',');
+  m_output.print(loopPeriod);
+  m_output.print(',');
+  m_output.print(debounceDelay);
+  m_output.print(',');
+  m_output.print(m_pushCount);
+  m_output.print(',');
+  m_output.print(m_missedPushCount);
+  m_output.print(',');
+  m_output.print(m_rejectedPushCount);
+  m_output.print(',');
+  m_output.print(rejectedPerThousand);
+  m_output.print(',');
+  m_output.print(getLatencyPercentile(50));
+  m_output.print(',');
+  m_output.print(getLatencyPercentile(90));
+  m_output.print(',');
+  m_output.print(getLatencyPercentile(99));
+  m_output.print(',');
+  m_output.println(getLatencyPercentile(100));
+}
+
+unsigned int BounceReplay::getPushCount() const {
+  return m_pushCount;
+}
+
+unsigned int BounceReplay::getMissedPushCount() const {
+  return m_missedPushCount;
+}
+
+unsigned int BounceReplay::getRejectedPushCount() const {
+  return m_rejectedPushCount;
+}
+
+unsigned long BounceReplay::getLatencyPercentile(byte percent) const {
+  unsigned long latency = 0L;
+  unsigned int rank;
+
+  if (m_latencyCount > 0 && percent > 0) {
+    if (percent > 100) {
+      percent = 100;
+    }
+
+    rank = ((unsigned long) percent * m_latencyCount + 99) / 100;
+    latency = m_latencies[rank - 1];
+  }
+
+  return latency;
+}
+
+BounceReplay::~BounceReplay() {
+
+}
+
+void BounceReplay::replayTrace(PushButton& button,
+                               LoopFunction loopFunction,
+                               const PinTraceEvent events[],
+                               unsigned int eventCount,
+                               unsigned long loopPeriod,
+                               unsigned long debounceDelay) {
+  int activeValue = button.getActiveValue();
+  unsigned int eventIndex = 0;
+  unsigned long settleTime = debounceDelay + 2 * loopPeriod;
+  unsigned long holdEndTime = settleTime;
+  bool isButtonPushed;
+
+  if (eventCount > 0) {
+    holdEndTime += events[eventCount - 1].time;
+  }
+
+  m_buttonPinNumber = button.getButtonPinNumber();
+  m_traceValue = !activeValue;
+  m_isLedValueKnown = false;
+  m_isPushPending = false;
+
+  m_previousReadFunction = PushButton::getReadFunction();
+  m_previousAnalogObserver = AnalogLed::getWriteObserver();
+  m_previousDigitalObserver = DigitalLed::getWriteObserver();
+  s_activeReplay = this;
+  PushButton::setReadFunction(readTrace);
+  AnalogLed::setWriteObserver(recordAnalogWrite);
+  DigitalLed::setWriteObserver(recordDigitalWrite);
+  button.resetButton();
+
+  for (m_replayTime = 0L; m_replayTime <= holdEndTime + settleTime;
+       m_replayTime += loopPeriod) {
+    // A press starts at the first active edge while the button is
+    // released, even if the loop reads the pin later.
+    while (eventIndex < eventCount &&
+           events[eventIndex].time <= m_replayTime) {
+      m_traceValue = events[eventIndex].value;
+
+      if (m_traceValue == activeValue && !m_isPushPending &&
+          button.getButtonPushState() != activeValue) {
+        m_pushStartTime = events[eventIndex].time;
+        m_isPushPending = true;
+        m_isPushLit = false;
+      }
+
+      eventIndex++;
+    }
+
+    if (m_replayTime > holdEndTime) {
+      m_traceValue = !activeValue;
+    }
+
+    isButtonPushed = button.getButtonPushState() == activeValue;
+    loopFunction(loopPeriod, debounceDelay);
+
+    // The press ends when the button is released again or the push is
+    // rejected.
+    if (button.getButtonPushState() != activeValue &&
+        (isButtonPushed ||
+         button.getRejectedPushCount() != m_rejectedPushCount)) {
+      endPush();
+    }
+
+    m_rejectedPushCount = button.getRejectedPushCount();
+  }
+
+  endPush();
+
+  s_activeReplay = NULL;
+  PushButton::setReadFunction(m_previousReadFunction);
+  AnalogLed::setWriteObserver(m_previousAnalogObserver);
+  DigitalLed::setWriteObserver(m_previousDigitalObserver);
+}
+
+void BounceReplay::recordLedWrite(int pinNumber, unsigned int value) {
+  if (pinNumber == m_ledPinNumber) {
+    if (m_isPushPending && !m_isPushLit &&
+        (!m_isLedValueKnown || value != m_ledValue)) {
+      if (m_latencyCount < m_latencyCapacity) {
+        m_latencies[m_latencyCount] = m_replayTime - m_pushStartTime;
+        m_latencyCount++;
+      }
+
+      m_pushCount++;
+      m_isPushLit = true;
+    }
+
+    m_ledValue = value;
+    m_isLedValueKnown = true;
+  }
+}
+
+void BounceReplay::endPush() {
+  if (m_isPushPending && !m_isPushLit) {
+    m_missedPushCount++;
+  }
+
+  m_isPushPending = false;
+}
+
+void BounceReplay::sortLatencies() {
+  // Insertion sort, since the latency arrays are small.
+  for (unsigned int i = 1; i < m_latencyCount; i++) {
+    unsigned long latency = m_latencies[i];
+    unsigned int j = i;
+
+    while (j > 0 && m_latencies[j - 1] > latency) {
+      m_latencies[j] = m_latencies[j - 1];
+      j--;
+    }
+
+    m_latencies[j] = latency;
+  }
+}
+
+int BounceReplay::readTrace(int pinNumber) {
+  int reading;
+
+  if (s_activeReplay != NULL &&
+      pinNumber == s_activeReplay->m_buttonPinNumber) {
+    reading = s_activeReplay->m_traceValue;
+  } else if (s_activeReplay != NULL &&
+             s_activeReplay->m_previousReadFunction != NULL) {
+    reading = s_activeReplay->m_previousReadFunction(pinNumber);
+  } else {
+    reading = digitalRead(pinNumber);
+  }
+
+  return reading;
+}
+
+void BounceReplay::recordAnalogWrite(int pinNumber, unsigned int value) {
+  if (s_activeReplay != NULL) {
+    s_activeReplay->recordLedWrite(pinNumber, value);
+
+    if (s_activeReplay->m_previousAnalogObserver != NULL) {
+      s_activeReplay->m_previousAnalogObserver(pinNumber, value);
+    }
+  }
+}
+
+void BounceReplay::recordDigitalWrite(int pinNumber, unsigned int value) {
+  if (s_activeReplay != NULL) {
+    s_activeReplay->recordLedWrite(pinNumber, value);
+
+    if (s_activeReplay->m_previousDigitalObserver != NULL) {
+      s_activeReplay->m_previousDigitalObserver(pinNumber, value);
+    }
+  }
+}
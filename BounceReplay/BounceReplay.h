@@ -0,0 +1,229 @@
+/**
+ * BounceReplay class.
+ *
+ * This class replays recorded bounce traces through a sketch's push
+ * button and LED code, so the debounce settings can be compared on the
+ * same switch behavior. Each trace is replayed at a given loop period
+ * and debounce delay, and the press-to-light latency percentiles,
+ * missed presses and rejected pushes are reported as one CSV line.
+ *
+ * A trace is a PinTraceEvent array with the time (ms) and pin state
+ * of each change of the button reading, e.g. recorded with a logic
+ * analyzer. The pin numbers of the events are ignored. The trace is
+ * fed to the push button through PushButton::setReadFunction(), so no
+ * pin is driven and the replay also runs on a host computer. Each
+ * loop, the sketch's loop function is called with the loop period and
+ * debounce delay, as loop() would call it.
+ *
+ * The latency of a press is measured from the trace time of its first
+ * active edge, including any bouncing, until the LED pin first changes
+ * after it, as seen by the write observers of AnalogLed and
+ * DigitalLed. A press that ends, or is rejected, without changing the
+ * LED pin is counted as missed.
+ *
+ * Example:
+ *   const PinTraceEvent bounceTrace[] = {
+ *     {100, 0, LOW}, {101, 0, HIGH}, {103, 0, LOW},
+ *     {400, 0, HIGH}, {402, 0, LOW}, {404, 0, HIGH}
+ *   };
+ *   unsigned long latencies[20];
+ *   PushButton button(2, PULL_UP);
+ *   DigitalLed led(13);
+ *   BounceReplay replay(Serial, latencies, 20);
+ *   replay.writeHeader();
+ *   replay.run("5 ms loop", button, 13,
+ *       [](unsigned long deltaMillis, unsigned long debounceDelay) {
+ *         if (!button.detectPush(deltaMillis, debounceDelay)) {
+ *         } else if (led.getLedPinState() == HIGH) {
+ *           led.resetLed();
+ *         } else {
+ *           led.showSteadyLed(deltaMillis);
+ *         }
+ *       }, bounceTrace, 6, 5, 20);
+ *
+ * @author Janette H. Griggs
+ * @version 1.1 10/19/26
+ */
+
+#ifndef BounceReplay_h
+  #define BounceReplay_h
+
+#ifndef __AVR_ATmega328P__
+  #define __AVR_ATmega328P__
+#endif
+#ifndef Arduino_h
+  #include <Arduino.h>
+#endif
+#ifndef AnalogLed_h
+  #include <AnalogLed.h>
+#endif
+#ifndef DigitalLed_h
+  #include <DigitalLed.h>
+#endif
+#ifndef PushButton_h
+  #include <PushButton.h>
+#endif
+#ifndef PinTraceEvent_h
+  #include <PinTraceEvent.h>
+#endif
+
+class BounceReplay {
+  public:
+    /**
+     * Function that runs the sketch's push button and LED code for one
+     * loop.
+     */
+    typedef void (*LoopFunction)(unsigned long deltaMillis,
+                                 unsigned long debounceDelay);
+
+    /**
+     * Constructor.
+     * @param output The output to write the results to, e.g. Serial.
+     * @param latencies The array to keep the press-to-light latencies
+     * of a replay in. The array must exist for as long as the replay
+     * does.
+     * @param latencyCapacity The number of latencies the array holds.
+     * Presses beyond it are counted but not in the percentiles.
+     */
+    BounceReplay(Print& output, unsigned long latencies[],
+                 unsigned int latencyCapacity);
+
+    /**
+     * Writes the CSV header line.
+     */
+    void writeHeader();
+
+    /**
+     * Replays a trace through a push button and writes one CSV line
+     * with the name, loop period (ms), debounce delay (ms), number of
+     * presses that changed the LED, number of missed presses, number
+     * of rejected pushes, rejected pushes per 1000 pushes read and the
+     * 50th, 90th and 99th percentile and maximum of the press-to-light
+     * latency (ms).
+     * The push button is reset first. After the last event, the trace
+     * value is held and then released for long enough that the button
+     * settles. The read function and write observers are restored
+     * afterwards, and are still called for other pins meanwhile.
+     * @param name The name of the replay.
+     * @param button The push button the trace is fed to.
+     * @param ledPinNumber The pin number of the LED that reacts to the
+     * push button.
+     * @param loopFunction The loop function.
+     * @param events The trace events, in time order.
+     * @param eventCount The number of trace events.
+     * @param loopPeriod The change in time (ms) of each loop. It must
+     * be more than 0.
+     * @param debounceDelay The debounce delay (ms) passed to the loop
+     * function.
+     */
+    void run(const char* name, PushButton& button, int ledPinNumber,
+             LoopFunction loopFunction, const PinTraceEvent events[],
+             unsigned int eventCount, unsigned long loopPeriod,
+             unsigned long debounceDelay);
+
+    /**
+     * Returns the number of presses that changed the LED in the last
+     * replay.
+     * @return The push count.
+     */
+    unsigned int getPushCount() const;
+
+    /**
+     * Returns the number of presses that didn't change the LED in the
+     * last replay.
+     * @return The missed push count.
+     */
+    unsigned int getMissedPushCount() const;
+
+    /**
+     * Returns the number of pushes rejected in the last replay.
+     * @return The rejected push count.
+     */
+    unsigned int getRejectedPushCount() const;
+
+    /**
+     * Returns a percentile of the press-to-light latency (in ms) of the
+     * last replay, using the nearest rank.
+     * @param percent The percentile, from 1 to 100.
+     * @return The latency, or 0 if no press changed the LED.
+     */
+    unsigned long getLatencyPercentile(byte percent) const;
+
+    /**
+     * Destructor.
+     */
+    ~BounceReplay();
+  private:
+    static BounceReplay* s_activeReplay; /**< replay that is running */
+
+    Print& m_output; /**< output for the results */
+    unsigned long* m_latencies; /**< press-to-light latencies (ms),
+                                sorted after each replay */
+    unsigned int m_latencyCapacity; /**< size of the latency array */
+    unsigned int m_latencyCount; /**< number of latencies kept */
+    unsigned int m_pushCount; /**< number of presses that changed the
+                              LED */
+    unsigned int m_missedPushCount; /**< number of presses that didn't
+                                    change the LED */
+    unsigned int m_rejectedPushCount; /**< number of rejected pushes */
+    int m_buttonPinNumber; /**< pin number the trace is fed to */
+    int m_traceValue; /**< trace value at the replay time */
+    int m_ledPinNumber; /**< pin number of the LED */
+    unsigned int m_ledValue; /**< last value written to the LED */
+    bool m_isLedValueKnown; /**< LED was written during the replay */
+    unsigned long m_replayTime; /**< time (ms) since the replay started */
+    unsigned long m_pushStartTime; /**< trace time (ms) of the first
+                                   active edge of the press */
+    bool m_isPushPending; /**< a press is in progress */
+    bool m_isPushLit; /**< the press changed the LED */
+    PushButton::ReadFunction m_previousReadFunction; /**< read function
+                                                     before the replay */
+    AnalogLed::WriteObserver m_previousAnalogObserver; /**< AnalogLed
+                                                       observer before
+                                                       the replay */
+    DigitalLed::WriteObserver m_previousDigitalObserver; /**< DigitalLed
+                                                         observer before
+                                                         the replay */
+
+    /**
+     * Replays the trace and keeps the latency of each press.
+     */
+    void replayTrace(PushButton& button, LoopFunction loopFunction,
+                     const PinTraceEvent events[],
+                     unsigned int eventCount, unsigned long loopPeriod,
+                     unsigned long debounceDelay);
+
+    /**
+     * Records a write to the LED pin.
+     */
+    void recordLedWrite(int pinNumber, unsigned int value);
+
+    /**
+     * Ends the press in progress, counting it as missed if it didn't
+     * change the LED.
+     */
+    void endPush();
+
+    /**
+     * Sorts the kept latencies in ascending order.
+     */
+    void sortLatencies();
+
+    /**
+     * Returns the trace value for the button pin, and reads other pins
+     * as before the replay.
+     */
+    static int readTrace(int pinNumber);
+
+    /**
+     * Records a write by AnalogLed and calls the previous observer.
+     */
+    static void recordAnalogWrite(int pinNumber, unsigned int value);
+
+    /**
+     * Records a write by DigitalLed and calls the previous observer.
+     */
+    static void recordDigitalWrite(int pinNumber, unsigned int value);
+};
+
+#endif
@@ -0,0 +1,251 @@
+// Function definitions for the CharlieplexLed class.
+
+// @author Janette H. Griggs
+// @version 1.2 10/19/26
+
+#include "CharlieplexLed.h"
+
+CharlieplexLed* CharlieplexLed::s_scanningDriver = NULL;
+
+ISR(TIMER2_COMPA_vect) {
+  CharlieplexLed::scanNextRow();
+}
+
+CharlieplexLed::CharlieplexLed(const byte pinNumbers[], byte pinCount) {
+  byte port = NOT_A_PORT;
+
+  // With fewer than 2 pins there are no LEDs, and the LED number 
+  // calculations would divide by 0.
+  if (pinCount < 2) {
+    pinCount = 0;
+  } else if (pinCount > MAX_PIN_COUNT) {
+    pinCount = MAX_PIN_COUNT;
+  }
+
+  m_outputRegister = NULL;
+  m_modeRegister = NULL;
+
+  if (pinCount > 0) {
+    port = digitalPinToPort(pinNumbers[0]);
+    m_outputRegister = portOutputRegister(port);
+    m_modeRegister = portModeRegister(port);
+  }
+
+  m_pinCount = pinCount;
+  m_allPinsMask = 0;
+  m_scanRow = 0;
+  m_blinkTimer = 0L;
+  m_isBlinkOn = true;
+
+  for (byte i = 0; i < m_pinCount; i++) {
+    if (digitalPinToPort(pinNumbers[i]) == port) {
+      m_pinMasks[i] = digitalPinToBitMask(pinNumbers[i]);
+    } else {
+      m_pinMasks[i] = 0;
+    }
+
+    m_allPinsMask |= m_pinMasks[i];
+  }
+
+  resetAllLeds();
+
+  if (m_pinCount > 0) {
+    *m_modeRegister &= ~m_allPinsMask;
+    *m_outputRegister &= ~m_allPinsMask;
+  }
+}
+
+byte CharlieplexLed::getPinCount() const {
+  return m_pinCount;
+}
+
+byte CharlieplexLed::getLedCount() const {
+  byte ledCount = 0;
+
+  if (m_pinCount > 0) {
+    ledCount = m_pinCount * (m_pinCount - 1);
+  }
+
+  return ledCount;
+}
+
+bool CharlieplexLed::getIsLedOn(byte ledNumber) const {
+  bool isLedOn = false;
+  byte row;
+
+  if (ledNumber < getLedCount()) {
+    row = calculateRow(ledNumber);
+    isLedOn = ((m_steadyMasks[row] | m_blinkMasks[row]) &
+               calculateCathodeMask(ledNumber)) != 0;
+  }
+
+  return isLedOn;
+}
+
+bool CharlieplexLed::getIsBlinkingState(byte ledNumber) const {
+  bool isBlinking = false;
+
+  if (ledNumber < getLedCount()) {
+    isBlinking = (m_blinkMasks[calculateRow(ledNumber)] &
+                  calculateCathodeMask(ledNumber)) != 0;
+  }
+
+  return isBlinking;
+}
+
+unsigned long CharlieplexLed::getBlinkTimer() const {
+  return m_blinkTimer;
+}
+
+void CharlieplexLed::showSteadyLed(byte ledNumber) {
+  byte row;
+  byte cathodeMask;
+
+  if (ledNumber < getLedCount()) {
+    row = calculateRow(ledNumber);
+    cathodeMask = calculateCathodeMask(ledNumber);
+
+    m_steadyMasks[row] |= cathodeMask;
+    m_blinkMasks[row] &= ~cathodeMask;
+    updateRow(row);
+  }
+}
+
+void CharlieplexLed::showBlinkingLed(byte ledNumber) {
+  byte row;
+  byte cathodeMask;
+
+  if (ledNumber < getLedCount()) {
+    row = calculateRow(ledNumber);
+    cathodeMask = calculateCathodeMask(ledNumber);
+
+    m_steadyMasks[row] &= ~cathodeMask;
+    m_blinkMasks[row] |= cathodeMask;
+    updateRow(row);
+  }
+}
+
+void CharlieplexLed::resetLed(byte ledNumber) {
+  byte row;
+  byte cathodeMask;
+
+  if (ledNumber < getLedCount()) {
+    row = calculateRow(ledNumber);
+    cathodeMask = calculateCathodeMask(ledNumber);
+
+    m_steadyMasks[row] &= ~cathodeMask;
+    m_blinkMasks[row] &= ~cathodeMask;
+    updateRow(row);
+  }
+}
+
+void CharlieplexLed::resetAllLeds() {
+  for (byte i = 0; i < MAX_PIN_COUNT; i++) {
+    m_steadyMasks[i] = 0;
+    m_blinkMasks[i] = 0;
+    m_rowMasks[i] = 0;
+  }
+}
+
+void CharlieplexLed::updateBlinking(unsigned long deltaMillis,
+                                    unsigned long blinkInterval) {
+  m_blinkTimer += deltaMillis;
+
+  if (m_blinkTimer >= blinkInterval) {
+    m_isBlinkOn = !m_isBlinkOn;
+    m_blinkTimer = 0L;
+
+    for (byte i = 0; i < m_pinCount; i++) {
+      updateRow(i);
+    }
+  }
+}
+
+void CharlieplexLed::startScanning(unsigned int refreshRate) {
+  unsigned long compareValue;
+
+  if (m_pinCount > 0 && refreshRate > 0) {
+    compareValue = F_CPU / 128 / 
+                   ((unsigned long) refreshRate * m_pinCount);
+
+    if (compareValue > 256) {
+      compareValue = 256;
+    } else if (compareValue < 2) {
+      compareValue = 2;
+    }
+
+    s_scanningDriver = this;
+
+    // CTC mode with OCR2A as TOP and a prescaler of 128.
+    TCCR2A = _BV(WGM21);
+    TCCR2B = _BV(CS22) | _BV(CS20);
+    OCR2A = compareValue - 1;
+    TIMSK2 |= _BV(OCIE2A);
+  }
+}
+
+void CharlieplexLed::stopScanning() {
+  TIMSK2 &= ~_BV(OCIE2A);
+  s_scanningDriver = NULL;
+
+  if (m_pinCount > 0) {
+    *m_modeRegister &= ~m_allPinsMask;
+    *m_outputRegister &= ~m_allPinsMask;
+  }
+}
+
+void CharlieplexLed::scanNextRow() {
+  if (s_scanningDriver != NULL) {
+    s_scanningDriver->scanRow();
+  }
+}
+
+byte CharlieplexLed::calculateRow(byte ledNumber) const {
+  return ledNumber / (m_pinCount - 1);
+}
+
+byte CharlieplexLed::calculateCathodeMask(byte ledNumber) const {
+  byte row = calculateRow(ledNumber);
+  byte cathode = ledNumber % (m_pinCount - 1);
+
+  // The anode pin of the row is skipped.
+  if (cathode >= row) {
+    cathode++;
+  }
+
+  return m_pinMasks[cathode];
+}
+
+void CharlieplexLed::updateRow(byte row) {
+  if (m_isBlinkOn) {
+    m_rowMasks[row] = m_steadyMasks[row] | m_blinkMasks[row];
+  } else {
+    m_rowMasks[row] = m_steadyMasks[row];
+  }
+}
+
+void CharlieplexLed::scanRow() {
+  byte anodeMask;
+
+  // Turn all pins to inputs before switching rows, so no LED of the
+  // previous row lights for a moment in the next one.
+  *m_modeRegister &= ~m_allPinsMask;
+
+  m_scanRow++;
+
+  if (m_scanRow >= m_pinCount) {
+    m_scanRow = 0;
+  }
+
+  anodeMask = m_pinMasks[m_scanRow];
+
+  // The cathodes stay low, since only the anode bit is set.
+  *m_outputRegister = (*m_outputRegister & ~m_allPinsMask) | anodeMask;
+  *m_modeRegister |= anodeMask | m_rowMasks[m_scanRow];
+}
+
+CharlieplexLed::~CharlieplexLed() {
+  if (s_scanningDriver == this) {
+    stopScanning();
+  }
+}
@@ -0,0 +1,198 @@
+/**
+ * CharlieplexLed class.
+ *
+ * This class drives up to N * (N - 1) LEDs from N pins on the Arduino
+ * Uno by charlieplexing. There is one row for each pin: while a row is
+ * shown, its pin drives the anodes high, the pins of the lit LEDs in 
+ * the row sink their cathodes low and all other pins are inputs 
+ * (tri-state). The rows are shown one at a time from the Timer2 
+ * compare interrupt, fast enough that all the LEDs appear lit at once.
+ *
+ * All pins must be on the same port, i.e. pins 0 to 7, 8 to 13 or A0
+ * to A5, so each row is shown with a few writes to the port and data
+ * direction registers instead of pinMode() and digitalWrite() calls.
+ * The lit LEDs of each row are kept as the port bits of their 
+ * cathodes, which is the value the interrupt writes.
+ *
+ * Each LED can be turned off, on (steady) or blinking, as with 
+ * DigitalLed. Blinking LEDs share the blink interval of the driver, so
+ * the blink state takes one bit per LED instead of a timer.
+ *
+ * NOTE: Scanning uses Timer2, so analogWrite() can't be used on pins 3
+ * and 11, and only one CharlieplexLed can scan at a time. The library
+ * defines the Timer2 compare A interrupt, so it can't be used in the
+ * same sketch as tone(). It is kept apart from the DigitalLed library,
+ * so sketches that only use DigitalLed don't define the interrupt.
+ *
+ * Example, 3 pins and 6 LEDs:
+ *   const byte pins[] = {8, 9, 10};
+ *   CharlieplexLed leds(pins, 3);
+ *   leds.startScanning(100);
+ *   leds.showBlinkingLed(4);
+ *   // in loop(): leds.updateBlinking(deltaMillis, 500);
+ *
+ * @author Janette H. Griggs
+ * @version 1.1 10/19/26
+ */
+
+#ifndef CharlieplexLed_h
+  #define CharlieplexLed_h
+
+#ifndef __AVR_ATmega328P__
+  #define __AVR_ATmega328P__
+#endif
+#ifndef Arduino_h
+  #include <Arduino.h>
+#endif
+
+class CharlieplexLed {
+  public:
+    static const byte MAX_PIN_COUNT = 8; /**< most pins, i.e. one port */
+
+    /**
+     * Constructor.
+     * Configures the pins as inputs with all LEDs turned off. LED n is
+     * lit by anode pin n / (pinCount - 1) and cathode pin 
+     * n % (pinCount - 1), skipping the anode pin itself.
+     * @param pinNumbers The Arduino pin numbers, all on the same port.
+     * Pins on a different port than the first pin are not used.
+     * @param pinCount The number of pins, at most MAX_PIN_COUNT. With
+     * fewer than 2 pins there are no LEDs and no pins are used.
+     */
+    CharlieplexLed(const byte pinNumbers[], byte pinCount);
+
+    /**
+     * Returns the number of pins.
+     * @return The pin count.
+     */
+    byte getPinCount() const;
+
+    /**
+     * Returns the number of LEDs, which is pinCount * (pinCount - 1).
+     * @return The LED count.
+     */
+    byte getLedCount() const;
+
+    /**
+     * Returns whether an LED is on, either steady or blinking.
+     * @param ledNumber The LED number.
+     * @return The truth value of whether the LED is on or not.
+     */
+    bool getIsLedOn(byte ledNumber) const;
+
+    /**
+     * Returns whether an LED is blinking.
+     * @param ledNumber The LED number.
+     * @return The blinking state of the LED.
+     */
+    bool getIsBlinkingState(byte ledNumber) const;
+
+    /**
+     * Returns the time (in ms) since the blinking LEDs last switched.
+     * @return The blink timer.
+     */
+    unsigned long getBlinkTimer() const;
+
+    /**
+     * Turns on an LED and stops it blinking.
+     * @param ledNumber The LED number.
+     */
+    void showSteadyLed(byte ledNumber);
+
+    /**
+     * Blinks an LED, in step with the other blinking LEDs.
+     * NOTE: Call updateBlinking() during each loop to maintain 
+     * blinking LED activity.
+     * @param ledNumber The LED number.
+     */
+    void showBlinkingLed(byte ledNumber);
+
+    /**
+     * Turns off an LED.
+     * @param ledNumber The LED number.
+     */
+    void resetLed(byte ledNumber);
+
+    /**
+     * Turns off all the LEDs.
+     */
+    void resetAllLeds();
+
+    /**
+     * Switches the blinking LEDs on or off based on the specified 
+     * interval.
+     * NOTE: Call this function during each loop.
+     * @param deltaMillis The change in time (ms) from the previous loop.
+     * @param blinkInterval The interval (in ms) between on and off.
+     */
+    void updateBlinking(unsigned long deltaMillis,
+                        unsigned long blinkInterval);
+
+    /**
+     * Starts showing the rows from the Timer2 compare interrupt. Does
+     * nothing if there are no LEDs or the refresh rate is 0.
+     * @param refreshRate The number of times (per s) all the rows are
+     * shown. Rates below 125000 / (256 * pinCount), e.g. 62 for 8 pins,
+     * are raised to that rate.
+     */
+    void startScanning(unsigned int refreshRate);
+
+    /**
+     * Stops the interrupt and turns off all the pins.
+     */
+    void stopScanning();
+
+    /**
+     * Shows the next row of the scanning driver.
+     * NOTE: This is called from the Timer2 compare interrupt.
+     */
+    static void scanNextRow();
+
+    /**
+     * Destructor.
+     */
+    ~CharlieplexLed();
+  private:
+    volatile uint8_t* m_outputRegister; /**< port output register */
+    volatile uint8_t* m_modeRegister; /**< port data direction 
+                                      register */
+    byte m_pinMasks[MAX_PIN_COUNT]; /**< port bit of each pin */
+    byte m_pinCount; /**< number of pins */
+    byte m_allPinsMask; /**< port bits of all pins */
+    byte m_steadyMasks[MAX_PIN_COUNT]; /**< cathode bits of the steady
+                                       LEDs in each row */
+    byte m_blinkMasks[MAX_PIN_COUNT]; /**< cathode bits of the blinking
+                                      LEDs in each row */
+    volatile byte m_rowMasks[MAX_PIN_COUNT]; /**< cathode bits of the 
+                                             lit LEDs in each row, as 
+                                             shown by the interrupt */
+    volatile byte m_scanRow; /**< row being shown */
+    unsigned long m_blinkTimer; /**< time (ms) since the blinking LEDs
+                                switched */
+    bool m_isBlinkOn; /**< blinking LEDs are lit */
+
+    static CharlieplexLed* s_scanningDriver; /**< driver shown by the
+                                             interrupt */
+
+    /**
+     * Returns the row (anode pin) of an LED.
+     */
+    byte calculateRow(byte ledNumber) const;
+
+    /**
+     * Returns the cathode port bit of an LED.
+     */
+    byte calculateCathodeMask(byte ledNumber) const;
+
+    /**
+     * Updates the lit LEDs of a row for the interrupt.
+     */
+    void updateRow(byte row);
+
+    /**
+     * Shows the next row.
+     */
+    void scanRow();
+};
+
+#endif
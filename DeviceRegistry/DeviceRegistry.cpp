@@ -0,0 +1,277 @@
+// Function definitions for the DeviceRegistry class.
+
+// @author Janette H. Griggs
+// @version 1.1 10/19/26
+
+#include "DeviceRegistry.h"
+#include <util/atomic.h>
+
+RegisteredDevice DeviceRegistry::s_devices[MAX_DEVICE_COUNT];
+byte DeviceRegistry::s_updateOrder[MAX_DEVICE_COUNT];
+byte DeviceRegistry::s_deviceCount = 0;
+
+byte DeviceRegistry::getDeviceCount() {
+  return s_deviceCount;
+}
+
+DeviceMode DeviceRegistry::getDeviceMode(byte deviceNumber) {
+  DeviceMode mode = DEVICE_OFF;
+  RegisteredDevice* device = findDevice(deviceNumber);
+
+  if (device != NULL) {
+    mode = (DeviceMode) device->mode;
+  }
+
+  return mode;
+}
+
+bool DeviceRegistry::getIsPushed(byte deviceNumber) {
+  bool isPushed = false;
+  RegisteredDevice* device = findDevice(deviceNumber);
+
+  if (device != NULL) {
+    isPushed = device->isPushed;
+  }
+
+  return isPushed;
+}
+
+void DeviceRegistry::setDeviceMode(byte deviceNumber, DeviceMode mode,
+                                   unsigned long interval) {
+  RegisteredDevice* device = findDevice(deviceNumber);
+
+  if (device != NULL && device->type != REGISTERED_PUSH_BUTTON) {
+    device->mode = mode;
+    device->interval = interval;
+
+    // A digital LED turned off here is written by the next update.
+    if (mode == DEVICE_OFF) {
+      if (device->type == REGISTERED_ANALOG_LED) {
+        ((AnalogLed*) device->device)->resetLed();
+      } else if (device->type == REGISTERED_RGB_LED) {
+        ((AnalogRGBLed*) device->device)->resetRGBLed();
+      } else {
+        ((DigitalLed*) device->device)->resetLed();
+      }
+    }
+  }
+}
+
+int DeviceRegistry::addAnalogLed(AnalogLed& led, DeviceMode mode,
+                                 unsigned long interval) {
+  return addDevice(REGISTERED_ANALOG_LED, &led, mode, interval, NULL, 0);
+}
+
+int DeviceRegistry::addRGBLed(AnalogRGBLed& led, DeviceMode mode,
+                              unsigned long interval) {
+  return addDevice(REGISTERED_RGB_LED, &led, mode, interval, NULL, 0);
+}
+
+int DeviceRegistry::addDigitalLed(DigitalLed& led, DeviceMode mode,
+                                  unsigned long interval) {
+  int deviceNumber = NO_DEVICE;
+  byte port = digitalPinToPort(led.getLedPinNumber());
+
+  if (port != NOT_A_PORT) {
+    deviceNumber = addDevice(REGISTERED_DIGITAL_LED, &led, mode,
+                             interval, portOutputRegister(port),
+                             digitalPinToBitMask(led.getLedPinNumber()));
+  }
+
+  // From now on the pin is only written once per port by updateAll().
+  if (deviceNumber != NO_DEVICE) {
+    led.setDeferringWrite(true);
+  }
+
+  return deviceNumber;
+}
+
+int DeviceRegistry::addPushButton(PushButton& button,
+                                  unsigned long debounceDelay) {
+  return addDevice(REGISTERED_PUSH_BUTTON, &button, DEVICE_OFF,
+                   debounceDelay, NULL, 0);
+}
+
+void DeviceRegistry::removeDevice(byte deviceNumber) {
+  RegisteredDevice* device = findDevice(deviceNumber);
+  byte position = 0;
+
+  if (device != NULL) {
+    if (device->type == REGISTERED_DIGITAL_LED) {
+      ((DigitalLed*) device->device)->setDeferringWrite(false);
+    }
+
+    while (s_updateOrder[position] != deviceNumber) {
+      position++;
+    }
+
+    for (byte i = position + 1; i < s_deviceCount; i++) {
+      s_updateOrder[i - 1] = s_updateOrder[i];
+    }
+
+    device->device = NULL;
+    s_deviceCount--;
+  }
+}
+
+void DeviceRegistry::updateAll(unsigned long deltaMillis) {
+  volatile byte* port = NULL;
+  byte setMask = 0;
+  byte clearMask = 0;
+  byte portPosition = 0;
+  byte portEndPosition = 0;
+
+  for (byte i = 0; i < s_deviceCount; i++) {
+    RegisteredDevice& device = s_devices[s_updateOrder[i]];
+
+    if (device.type == REGISTERED_PUSH_BUTTON) {
+      device.isPushed = ((PushButton*) device.device)->detectPush(
+          deltaMillis, device.interval);
+    } else if (device.type == REGISTERED_DIGITAL_LED) {
+      // The digital LEDs of a port are next to each other in the update
+      // order, so the port is written when the next port starts.
+      if (device.port != port) {
+        writePort(port, setMask, clearMask, portPosition, i);
+        port = device.port;
+        portPosition = i;
+        setMask = 0;
+        clearMask = 0;
+      }
+
+      if (device.mode != DEVICE_OFF) {
+        showLed(device, deltaMillis);
+      }
+
+      if (((DigitalLed*) device.device)->getLedPinState() == HIGH) {
+        setMask |= device.bitMask;
+      } else {
+        clearMask |= device.bitMask;
+      }
+
+      portEndPosition = i + 1;
+    } else if (device.mode != DEVICE_OFF) {
+      showLed(device, deltaMillis);
+    }
+  }
+
+  writePort(port, setMask, clearMask, portPosition, portEndPosition);
+}
+
+RegisteredDevice* DeviceRegistry::findDevice(byte deviceNumber) {
+  RegisteredDevice* device = NULL;
+
+  if (deviceNumber < MAX_DEVICE_COUNT &&
+      s_devices[deviceNumber].device != NULL) {
+    device = &s_devices[deviceNumber];
+  }
+
+  return device;
+}
+
+int DeviceRegistry::addDevice(RegisteredDeviceType type, void* device,
+                              byte mode, unsigned long interval,
+                              volatile byte* port, byte bitMask) {
+  int deviceNumber = NO_DEVICE;
+  byte position = 0;
+  bool isPortFound = false;
+
+  if (s_deviceCount < MAX_DEVICE_COUNT) {
+    deviceNumber = 0;
+
+    while (s_devices[deviceNumber].device != NULL) {
+      deviceNumber++;
+    }
+
+    s_devices[deviceNumber].type = type;
+    s_devices[deviceNumber].device = device;
+    s_devices[deviceNumber].mode = mode;
+    s_devices[deviceNumber].interval = interval;
+    s_devices[deviceNumber].port = port;
+    s_devices[deviceNumber].bitMask = bitMask;
+    s_devices[deviceNumber].isPushed = false;
+
+    // Insert the device after the last device of a lower type, or of
+    // the same type and port if there is one and else of the same type.
+    for (byte i = 0; i < s_deviceCount; i++) {
+      RegisteredDevice& other = s_devices[s_updateOrder[i]];
+
+      if (other.type < type) {
+        position = i + 1;
+      } else if (other.type == type) {
+        if (other.port == port) {
+          position = i + 1;
+          isPortFound = true;
+        } else if (!isPortFound) {
+          position = i + 1;
+        }
+      }
+    }
+
+    for (byte i = s_deviceCount; i > position; i--) {
+      s_updateOrder[i] = s_updateOrder[i - 1];
+    }
+
+    s_updateOrder[position] = deviceNumber;
+    s_deviceCount++;
+  }
+
+  return deviceNumber;
+}
+
+void DeviceRegistry::showLed(RegisteredDevice& device,
+                             unsigned long deltaMillis) {
+  if (device.type == REGISTERED_ANALOG_LED) {
+    AnalogLed* led = (AnalogLed*) device.device;
+
+    if (device.mode == DEVICE_BLINK) {
+      led->showBlinkingLed(deltaMillis, device.interval);
+    } else if (device.mode == DEVICE_FADE_IN) {
+      led->showFadingInLed(deltaMillis, device.interval);
+    } else if (device.mode == DEVICE_FADE_OUT) {
+      led->showFadingOutLed(deltaMillis, device.interval);
+    } else if (device.mode == DEVICE_FADE_IN_OUT) {
+      led->showFadingInOutLed(deltaMillis, device.interval);
+    } else {
+      led->showSteadyLed(deltaMillis);
+    }
+  } else if (device.type == REGISTERED_RGB_LED) {
+    AnalogRGBLed* led = (AnalogRGBLed*) device.device;
+
+    if (device.mode == DEVICE_BLINK) {
+      led->showBlinkingRGBLed(deltaMillis, device.interval);
+    } else if (device.mode == DEVICE_FADE_IN) {
+      led->showFadingInRGBLed(deltaMillis, device.interval);
+    } else if (device.mode == DEVICE_FADE_OUT) {
+      led->showFadingOutRGBLed(deltaMillis, device.interval);
+    } else if (device.mode == DEVICE_FADE_IN_OUT) {
+      led->showFadingInOutRGBLed(deltaMillis, device.interval);
+    } else {
+      led->showSteadyRGBLed(deltaMillis);
+    }
+  } else {
+    DigitalLed* led = (DigitalLed*) device.device;
+
+    if (device.mode == DEVICE_BLINK) {
+      led->showBlinkingLed(deltaMillis, device.interval);
+    } else {
+      led->showSteadyLed(deltaMillis);
+    }
+  }
+}
+
+void DeviceRegistry::writePort(volatile byte* port, byte setMask,
+                               byte clearMask, byte firstPosition,
+                               byte endPosition) {
+  if (port != NULL) {
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+      *port = (*port & ~clearMask) | setMask;
+    }
+
+    // The LEDs defer their writes, so the observer is called here,
+    // when their pins are actually written.
+    for (byte i = firstPosition; i < endPosition; i++) {
+      ((DigitalLed*) s_devices[s_updateOrder[i]].device)->
+          notifyWriteObserver();
+    }
+  }
+}
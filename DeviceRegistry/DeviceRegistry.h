@@ -0,0 +1,211 @@
+/**
+ * DeviceRegistry class.
+ *
+ * This class keeps the LEDs and push buttons of a sketch in one
+ * registry and updates all of them with a single call per loop, so the
+ * sketch no longer has to call each device itself. Each LED keeps the
+ * mode it was given and updateAll() calls its show function each loop.
+ * Each push button is checked with its debounce delay and
+ * getIsPushed() tells whether it was pushed in the last update.
+ *
+ * The registry is a fixed-size static array, so there are no heap
+ * allocations or virtual function calls. Devices are updated by type
+ * (analog LEDs, RGB LEDs, digital LEDs and push buttons), with the
+ * digital LEDs sorted by port. The pin writes of the digital LEDs are
+ * deferred and collected per port, and each port is written once per
+ * update with interrupts off, instead of once per digitalWrite().
+ *
+ * A device can be removed, e.g. to control a digital LED directly 
+ * again, and its device number is then reused by the next device
+ * added.
+ *
+ * Example:
+ *   DigitalLed redLed(2);
+ *   DigitalLed greenLed(3);
+ *   PushButton button(4, PULL_UP);
+ *   int buttonNumber;
+ *   // In setup():
+ *   DeviceRegistry::addDigitalLed(redLed, DEVICE_BLINK, 500);
+ *   DeviceRegistry::addDigitalLed(greenLed, DEVICE_STEADY);
+ *   buttonNumber = DeviceRegistry::addPushButton(button, 50);
+ *   // In loop():
+ *   DeviceRegistry::updateAll(deltaMillis);
+ *   if (DeviceRegistry::getIsPushed(buttonNumber)) { ... }
+ *
+ * @author Janette H. Griggs
+ * @version 1.1 10/19/26
+ */
+
+#ifndef DeviceRegistry_h
+  #define DeviceRegistry_h
+
+#ifndef __AVR_ATmega328P__
+  #define __AVR_ATmega328P__
+#endif
+#ifndef Arduino_h
+  #include <Arduino.h>
+#endif
+#ifndef AnalogLed_h
+  #include <AnalogLed.h>
+#endif
+#ifndef AnalogRGBLed_h
+  #include <AnalogRGBLed.h>
+#endif
+#ifndef DigitalLed_h
+  #include <DigitalLed.h>
+#endif
+#ifndef PushButton_h
+  #include <PushButton.h>
+#endif
+#ifndef RegisteredDevice_h
+  #include "RegisteredDevice.h"
+#endif
+
+class DeviceRegistry {
+  public:
+    static const int NO_DEVICE = -1; /**< device number when a device
+                                     can't be added */
+    static const byte MAX_DEVICE_COUNT = 16; /**< number of devices the
+                                             registry holds */
+
+    /**
+     * Returns the number of devices.
+     * @return The device count.
+     */
+    static byte getDeviceCount();
+
+    /**
+     * Returns the mode of an LED.
+     * @param deviceNumber The device number returned when the LED was
+     * added.
+     * @return The DeviceMode.
+     */
+    static DeviceMode getDeviceMode(byte deviceNumber);
+
+    /**
+     * Returns whether a push button was pushed in the last update.
+     * @param deviceNumber The device number returned when the push
+     * button was added.
+     * @return true if the push button was pushed.
+     */
+    static bool getIsPushed(byte deviceNumber);
+
+    /**
+     * Sets the mode of an LED. The LED is reset when the mode is
+     * DEVICE_OFF. Digital LEDs only blink or stay steady, so their
+     * fading modes are shown as a steady LED.
+     * @param deviceNumber The device number returned when the LED was
+     * added.
+     * @param mode The DeviceMode.
+     * @param interval The blink or fade interval (in ms).
+     */
+    static void setDeviceMode(byte deviceNumber, DeviceMode mode,
+                              unsigned long interval = 0);
+
+    /**
+     * Adds an analog LED.
+     * @param led The LED. It must exist for as long as it is 
+     * registered.
+     * @param mode The DeviceMode.
+     * @param interval The blink or fade interval (in ms).
+     * @return The device number, or NO_DEVICE if the registry is full.
+     */
+    static int addAnalogLed(AnalogLed& led, DeviceMode mode = DEVICE_OFF,
+                            unsigned long interval = 0);
+
+    /**
+     * Adds an RGB LED.
+     * @param led The LED. It must exist for as long as it is 
+     * registered.
+     * @param mode The DeviceMode.
+     * @param interval The blink or fade interval (in ms).
+     * @return The device number, or NO_DEVICE if the registry is full.
+     */
+    static int addRGBLed(AnalogRGBLed& led, DeviceMode mode = DEVICE_OFF,
+                         unsigned long interval = 0);
+
+    /**
+     * Adds a digital LED. From then on, its pin is only written by
+     * updateAll(): the LED's writes are deferred, so its own show 
+     * functions and resetLed() only change its pin state, and the pin
+     * and write observer follow at the next updateAll(). Remove the
+     * LED to write its pin directly again.
+     * @param led The LED. It must exist for as long as it is 
+     * registered.
+     * @param mode The DeviceMode.
+     * @param interval The blink interval (in ms).
+     * @return The device number, or NO_DEVICE if the registry is full.
+     */
+    static int addDigitalLed(DigitalLed& led, DeviceMode mode = DEVICE_OFF,
+                             unsigned long interval = 0);
+
+    /**
+     * Adds a push button.
+     * @param button The push button. It must exist for as long as it 
+     * is registered.
+     * @param debounceDelay The debounce delay (in ms) of the button.
+     * @return The device number, or NO_DEVICE if the registry is full.
+     */
+    static int addPushButton(PushButton& button,
+                             unsigned long debounceDelay);
+
+    /**
+     * Removes a device, so it is no longer updated. A digital LED 
+     * writes its pin directly again, starting with its next write.
+     * Nothing is done if there is no device with the number.
+     * @param deviceNumber The device number returned when the device
+     * was added.
+     */
+    static void removeDevice(byte deviceNumber);
+
+    /**
+     * Shows each LED in its mode, writes the digital LED pins once per
+     * port, calls the DigitalLed write observer for each digital LED 
+     * after its port is written and checks each push button.
+     * NOTE: Call this function during each loop.
+     * @param deltaMillis The change in time (ms) from the previous loop.
+     */
+    static void updateAll(unsigned long deltaMillis);
+  private:
+    static RegisteredDevice s_devices[MAX_DEVICE_COUNT]; /**< devices, by
+                                                         device number,
+                                                         with no device
+                                                         in free slots */
+    static byte s_updateOrder[MAX_DEVICE_COUNT]; /**< device numbers, in
+                                                 the order they are
+                                                 updated */
+    static byte s_deviceCount; /**< number of devices */
+
+    /**
+     * Returns the device with a device number, or NULL if there is 
+     * none.
+     */
+    static RegisteredDevice* findDevice(byte deviceNumber);
+
+    /**
+     * Adds a device of any type in the first free slot and inserts it
+     * into the update order after the devices of the same type and 
+     * port.
+     */
+    static int addDevice(RegisteredDeviceType type, void* device,
+                         byte mode, unsigned long interval,
+                         volatile byte* port, byte bitMask);
+
+    /**
+     * Shows an LED in its mode.
+     */
+    static void showLed(RegisteredDevice& device,
+                        unsigned long deltaMillis);
+
+    /**
+     * Sets and clears the bits of a port with interrupts off, so pins
+     * of the port changed from an interrupt are kept, and calls the 
+     * write observer for the digital LEDs of the port, which are at 
+     * the given positions in the update order.
+     */
+    static void writePort(volatile byte* port, byte setMask,
+                          byte clearMask, byte firstPosition,
+                          byte endPosition);
+};
+
+#endif
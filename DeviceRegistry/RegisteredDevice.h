@@ -0,0 +1,35 @@
+// RegisteredDevice struct and enums for DeviceRegistry.
+
+// @author Janette H. Griggs
+// @version 1.0 10/19/26
+
+#ifndef RegisteredDevice_h
+  #define RegisteredDevice_h
+
+#ifndef __AVR_ATmega328P__
+  #define __AVR_ATmega328P__
+#endif
+#ifndef Arduino_h
+  #include <Arduino.h>
+#endif
+
+// The types are in update order.
+enum RegisteredDeviceType {REGISTERED_ANALOG_LED, REGISTERED_RGB_LED,
+                           REGISTERED_DIGITAL_LED, 
+                           REGISTERED_PUSH_BUTTON};
+
+enum DeviceMode {DEVICE_OFF, DEVICE_STEADY, DEVICE_BLINK, DEVICE_FADE_IN,
+                 DEVICE_FADE_OUT, DEVICE_FADE_IN_OUT};
+
+struct RegisteredDevice {
+  byte type; /**< RegisteredDeviceType of the device */
+  void* device; /**< the LED or push button */
+  byte mode; /**< DeviceMode of an LED */
+  unsigned long interval; /**< blink or fade interval (ms) of an LED, or
+                          debounce delay (ms) of a push button */
+  volatile byte* port; /**< output register of a digital LED pin */
+  byte bitMask; /**< bit of a digital LED pin in its output register */
+  bool isPushed; /**< push button was pushed in the last update */
+};
+
+#endif
@@ -1,15 +1,25 @@
 // Function definitions for the DigitalLed class. 
 
 // @author Janette H. Griggs
-// @version 1.4 03/31/14
+// @version 1.16 10/19/26
 
 #include "DigitalLed.h"
+#include <util/atomic.h>
+
+DigitalLed::WriteObserver DigitalLed::s_writeObserver = NULL;
 
 DigitalLed::DigitalLed(int ledPinNumber) {
   m_blinkTimer = 0L;
   m_isBlinking = false;
+  m_pattern = 0L;
+  m_patternSlot = 0;
+  m_patternRepeat = 0;
+  m_isShowingPattern = false;
   m_activeTimer = 0L;
   m_isActive = false;
+  m_isCarryingRemainder = false;
+  m_isDeferringWrite = false;
+  resetTelemetry();
   
   setLedPinNumber(ledPinNumber);
   turnOffLed();
@@ -31,6 +41,14 @@ bool DigitalLed::getIsBlinkingState() const {
   return m_isBlinking;
 }
 
+bool DigitalLed::getIsShowingPatternState() const {
+  return m_isShowingPattern;
+}
+
+byte DigitalLed::getPatternRepeat() const {
+  return m_patternRepeat;
+}
+
 unsigned long DigitalLed::getActiveTimer() const {
   return m_activeTimer;
 }
@@ -39,6 +57,26 @@ bool DigitalLed::getIsActiveState() const {
   return m_isActive;
 }
 
+unsigned int DigitalLed::getLateUpdateCount() const {
+  return m_lateUpdateCount;
+}
+
+unsigned long DigitalLed::getLostRemainderTime() const {
+  return m_lostRemainderTime;
+}
+
+unsigned long DigitalLed::getMaxOvershoot() const {
+  return m_maxOvershoot;
+}
+
+bool DigitalLed::getIsCarryingRemainderState() const {
+  return m_isCarryingRemainder;
+}
+
+bool DigitalLed::getIsDeferringWriteState() const {
+  return m_isDeferringWrite;
+}
+
 void DigitalLed::setLedPinNumber(int ledPinNumber) {
   m_ledPinNumber = ledPinNumber;
 
@@ -46,6 +84,22 @@ void DigitalLed::setLedPinNumber(int ledPinNumber) {
   pinMode(m_ledPinNumber, OUTPUT);
 }
 
+void DigitalLed::setCarryingRemainder(bool isCarryingRemainder) {
+  m_isCarryingRemainder = isCarryingRemainder;
+}
+
+void DigitalLed::setDeferringWrite(bool isDeferringWrite) {
+  m_isDeferringWrite = isDeferringWrite;
+}
+
+DigitalLed::WriteObserver DigitalLed::getWriteObserver() {
+  return s_writeObserver;
+}
+
+void DigitalLed::setWriteObserver(WriteObserver writeObserver) {
+  s_writeObserver = writeObserver;
+}
+
 void DigitalLed::showSteadyLed(unsigned long deltaMillis) {
   stopBlinkingLed();
   activateLed(deltaMillis);
@@ -60,16 +114,115 @@ void DigitalLed::showBlinkingLed(unsigned long deltaMillis,
   // Blink the LED.
   if (!m_isBlinking) {
     m_isBlinking = true;
+    m_isShowingPattern = false;
     turnOnLed();
   } else {    
     m_blinkTimer += deltaMillis;
     if (m_blinkTimer >= blinkInterval) {
         switchLedPinState();
-        m_blinkTimer = 0L;
+        restartBlinkTimer(blinkInterval);
+    }
+  }
+}
+
+void DigitalLed::showPatternLed(unsigned long deltaMillis,
+                                unsigned long pattern,
+                                byte patternLength,
+                                unsigned long slotInterval,
+                                byte repeatCount,
+                                unsigned long gapInterval) {
+  activateLed(deltaMillis);
+
+  // An unsigned long holds at most MAX_PATTERN_LENGTH bits, and a 
+  // pattern without bits would restart on every update.
+  if (patternLength > MAX_PATTERN_LENGTH) {
+    patternLength = MAX_PATTERN_LENGTH;
+  }
+
+  // Show the pattern one bit per slot, shifting the next bit into
+  // place at the end of each slot. Between repeats, the LED is off
+  // for the gap interval.
+  if (patternLength == 0) {
+    stopBlinkingLed();
+    turnOffLed();
+  } else if (!m_isShowingPattern) {
+    stopBlinkingLed();
+    m_isShowingPattern = true;
+    m_patternRepeat = 0;
+    startPattern(pattern, patternLength);
+  } else if (m_patternSlot > 0) {
+    m_blinkTimer += deltaMillis;
+
+    if (m_blinkTimer >= slotInterval) {
+      restartBlinkTimer(slotInterval);
+      m_pattern >>= 1;
+      m_patternSlot--;
+
+      if (m_patternSlot > 0) {
+        showPatternSlot();
+      } else {
+        m_patternRepeat++;
+        turnOffLed();
+
+        if (gapInterval == 0 && 
+            (repeatCount == 0 || m_patternRepeat < repeatCount)) {
+          startPattern(pattern, patternLength);
+        }
+      }
+    }
+  } else if (repeatCount == 0 || m_patternRepeat < repeatCount) {
+    m_blinkTimer += deltaMillis;
+
+    if (m_blinkTimer >= gapInterval) {
+      restartBlinkTimer(gapInterval);
+      startPattern(pattern, patternLength);
     }
   }
 }
 
+void DigitalLed::resetTelemetry() {
+  m_lateUpdateCount = 0;
+  m_lostRemainderTime = 0L;
+  m_maxOvershoot = 0L;
+}
+
+void DigitalLed::saveSnapshot(LedSnapshot& snapshot) const {
+  // Copy the state with interrupts off, so an update from an interrupt
+  // can't change it partway through.
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    // The mode is 0 for steady, 1 for blinking and 2 for a pattern.
+    snapshot.mode = 0;
+
+    if (m_isBlinking) {
+      snapshot.mode = 1;
+    } else if (m_isShowingPattern) {
+      snapshot.mode = 2;
+    }
+
+    snapshot.flags = m_isActive;
+    snapshot.brightness = m_ledPinState;
+    snapshot.changeTimer = m_blinkTimer;
+    snapshot.activeTimer = m_activeTimer;
+  }
+}
+
+void DigitalLed::restoreSnapshot(const LedSnapshot& snapshot) {
+  // A pattern can't be resumed without its bits, so it starts over.
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    m_isBlinking = snapshot.mode == 1;
+    m_isShowingPattern = false;
+    m_isActive = snapshot.flags & 1;
+    m_blinkTimer = snapshot.changeTimer;
+    m_activeTimer = snapshot.activeTimer;
+  }
+
+  if (snapshot.brightness == HIGH) {
+    turnOnLed();
+  } else {
+    turnOffLed();
+  }
+}
+
 void DigitalLed::resetLed() {
   stopBlinkingLed();
   turnOffLed();
@@ -84,6 +237,31 @@ DigitalLed::~DigitalLed() {
 void DigitalLed::stopBlinkingLed() {
   m_blinkTimer = 0L;
   m_isBlinking = false;
+  m_isShowingPattern = false;
+}
+
+void DigitalLed::restartBlinkTimer(unsigned long interval) {
+  unsigned long overshoot = m_blinkTimer - interval;
+
+  m_blinkTimer = 0L;
+
+  if (overshoot > 0) {
+    if (overshoot > m_maxOvershoot) {
+      m_maxOvershoot = overshoot;
+    }
+
+    // Whole intervals that were skipped can't be made up, so only the
+    // part of the overshoot within the next interval is carried.
+    if (m_isCarryingRemainder && interval > 0) {
+      m_blinkTimer = overshoot % interval;
+    }
+
+    m_lostRemainderTime += overshoot - m_blinkTimer;
+
+    if (m_lateUpdateCount < 0xFFFF) {
+      m_lateUpdateCount++;
+    }
+  }
 }
 
 void DigitalLed::activateLed(unsigned long deltaMillis) {
@@ -96,12 +274,12 @@ void DigitalLed::activateLed(unsigned long deltaMillis) {
 
 void DigitalLed::turnOnLed() {
   m_ledPinState = HIGH;
-  digitalWrite(m_ledPinNumber, m_ledPinState);
+  writeLedPin();
 }
 
 void DigitalLed::turnOffLed() {
   m_ledPinState = LOW;
-  digitalWrite(m_ledPinNumber, m_ledPinState);
+  writeLedPin();
 }
 
 void DigitalLed::switchLedPinState() {
@@ -110,4 +288,28 @@ void DigitalLed::switchLedPinState() {
   } else {
     turnOnLed(); 
   }
+}
+
+void DigitalLed::startPattern(unsigned long pattern, byte patternLength) {
+  m_pattern = pattern;
+  m_patternSlot = patternLength;
+  showPatternSlot();
+}
+
+void DigitalLed::showPatternSlot() {
+  m_ledPinState = m_pattern & 1;
+  writeLedPin();
+}
+
+void DigitalLed::writeLedPin() {
+  if (!m_isDeferringWrite) {
+    digitalWrite(m_ledPinNumber, m_ledPinState);
+    notifyWriteObserver();
+  }
+}
+
+void DigitalLed::notifyWriteObserver() {
+  if (s_writeObserver != NULL) {
+    s_writeObserver(m_ledPinNumber, m_ledPinState);
+  }
 }
\ No newline at end of file
@@ -10,7 +10,7 @@
  * repository for an example of this class implementation.
  * 
  * @author Janette H. Griggs
- * @version 1.4 03/31/14
+ * @version 1.17 10/19/26
  */
 
 #ifndef DigitalLed_h
@@ -22,9 +22,21 @@
 #ifndef Arduino_h
   #include <Arduino.h>
 #endif
+#ifndef LedSnapshot_h
+  #include <LedSnapshot.h>
+#endif
 
 class DigitalLed {
   public:
+    static const byte MAX_PATTERN_LENGTH = 32; /**< number of bits in the
+                                               longest pattern */
+
+    /**
+     * Function called with the pin number and state of each write to
+     * an LED pin.
+     */
+    typedef void (*WriteObserver)(int pinNumber, unsigned int value);
+
     /**
      * Constructor.
      * Configures the LED light for digital output.
@@ -56,6 +68,18 @@ class DigitalLed {
      */
     bool getIsBlinkingState() const;
 
+    /**
+     * Returns the pattern state of the LED.
+     * @return The pattern state.
+     */
+    bool getIsShowingPatternState() const;
+
+    /**
+     * Returns the number of times the pattern has been shown.
+     * @return The pattern repeat count.
+     */
+    byte getPatternRepeat() const;
+
     /**
      * Returns the time (in ms) since the led was active. 
      * @return The active timer.
@@ -67,6 +91,42 @@ class DigitalLed {
      * @return The active state.
      */
     bool getIsActiveState() const;
+
+    /**
+     * Returns the number of blink or pattern steps that were late, 
+     * i.e. the timer was past the interval when the step was taken, 
+     * e.g. because the loop is slow or stalled. Stops counting at 
+     * 65535.
+     * @return The late update count.
+     */
+    unsigned int getLateUpdateCount() const;
+
+    /**
+     * Returns the total time (in ms) by which blink or pattern steps 
+     * were late and that was dropped instead of carried to the next 
+     * step.
+     * @return The lost remainder time.
+     */
+    unsigned long getLostRemainderTime() const;
+
+    /**
+     * Returns the most time (in ms) by which a blink or pattern step 
+     * was late.
+     * @return The maximum overshoot.
+     */
+    unsigned long getMaxOvershoot() const;
+
+    /**
+     * Returns the remainder carrying state of the LED.
+     * @return The remainder carrying state.
+     */
+    bool getIsCarryingRemainderState() const;
+
+    /**
+     * Returns the deferred write state of the LED.
+     * @return The deferred write state.
+     */
+    bool getIsDeferringWriteState() const;
     
     /**
      * Sets the LED pin number.
@@ -74,6 +134,41 @@ class DigitalLed {
      */
     void setLedPinNumber(int ledPinNumber); 
 
+    /**
+     * Turns remainder carrying on or off. When on, the time by which a
+     * blink or pattern step was late is carried into the next step 
+     * instead of being dropped, so the blink period stays accurate on
+     * average when the loop is slow. Whole intervals that were skipped
+     * are still dropped.
+     * @param isCarryingRemainder The remainder carrying state.
+     */
+    void setCarryingRemainder(bool isCarryingRemainder);
+
+    /**
+     * Turns deferred writes on or off. When on, the LED only keeps its
+     * pin state and doesn't write the pin or call the write observer,
+     * so the pins of several LEDs can be written together, e.g. once 
+     * per port by DeviceRegistry::updateAll(), which calls the write
+     * observer when the port is written.
+     * @param isDeferringWrite The deferred write state.
+     */
+    void setDeferringWrite(bool isDeferringWrite);
+
+    /**
+     * Returns the function called after every write to the pin of any
+     * DigitalLed, e.g. to call it from another observer.
+     * @return The write observer, or NULL for none.
+     */
+    static WriteObserver getWriteObserver();
+
+    /**
+     * Sets a function to be called after every write to the pin of any
+     * DigitalLed, e.g. PinTrace::recordDigitalWrite() to trace the LED
+     * output.
+     * @param writeObserver The write observer, or NULL for none.
+     */
+    static void setWriteObserver(WriteObserver writeObserver);
+
     /**
      * Turns on the LED and stops any blinking activity.
      * NOTE: Call this function during each loop to maintain steady 
@@ -93,6 +188,55 @@ class DigitalLed {
     void showBlinkingLed(unsigned long deltaMillis, 
                         unsigned long blinkInterval);
 
+    /**
+     * Shows an on/off pattern, such as a status code or Morse code,
+     * one bit per time slot, starting with the lowest bit. For example,
+     * 0b0111010101 shows three short blinks and one long blink.
+     * NOTE: Call this function during each loop, with the same 
+     * arguments, to maintain the pattern. Call showSteadyLed() or
+     * resetLed() first to restart a pattern from the beginning.
+     * @param deltaMillis The change in time (ms) from the previous loop.
+     * @param pattern The pattern bits, 1 for on (HIGH) and 0 for off 
+     * (LOW).
+     * @param patternLength The number of bits in the pattern, from 1 to
+     * MAX_PATTERN_LENGTH. Longer patterns are cut to MAX_PATTERN_LENGTH
+     * bits, and with 0 bits the LED stays off.
+     * @param slotInterval The time (ms) each bit is shown.
+     * @param repeatCount The number of times to show the pattern, or 0
+     * to repeat it until another activity is started. The LED stays 
+     * off when the pattern is done.
+     * @param gapInterval The time (ms) the LED is off between repeats.
+     */
+    void showPatternLed(unsigned long deltaMillis, unsigned long pattern,
+                        byte patternLength, unsigned long slotInterval,
+                        byte repeatCount = 0, 
+                        unsigned long gapInterval = 0);
+
+    /**
+     * Saves the blinking state, timers and pin state of the LED, e.g.
+     * to store in EEPROM with LedSnapshotStore. The state is copied 
+     * with interrupts off, so the snapshot is consistent even if the 
+     * LED is updated from an interrupt. Interrupts are off while 12 
+     * bytes are copied, an estimated 50 cycles (not measured).
+     * @param snapshot The snapshot to save into.
+     */
+    void saveSnapshot(LedSnapshot& snapshot) const;
+
+    /**
+     * Restores the LED from a snapshot and writes the restored pin 
+     * state, so calling the same show function as before the snapshot 
+     * resumes blinking in phase. A pattern or animation is not part of
+     * the snapshot and starts over.
+     * @param snapshot The snapshot to restore from.
+     */
+    void restoreSnapshot(const LedSnapshot& snapshot);
+
+    /**
+     * Sets the late update count, lost remainder time and maximum 
+     * overshoot to 0.
+     */
+    void resetTelemetry();
+
     /**
      * Turns off the LED and sets it to an inactive state.
      * Timers are set to 0.
@@ -106,19 +250,43 @@ class DigitalLed {
      */
     ~DigitalLed();
   private:
+    friend class DeviceRegistry;
+    friend class AnimationPlayer;
+
+    static WriteObserver s_writeObserver; /**< observer of LED pin writes */
+
     int m_ledPinNumber; /**< LED pin number */
     int m_ledPinState; /**< LED pin state */
     unsigned long m_blinkTimer; /**< time (ms) since last pin state */
     bool m_isBlinking; /**< blinking state of LED */
+    unsigned long m_pattern; /**< pattern bits left to show, starting 
+                             with the current slot */
+    byte m_patternSlot; /**< pattern slots left to show, 0 in the gap */
+    byte m_patternRepeat; /**< number of times the pattern was shown */
+    bool m_isShowingPattern; /**< pattern state of LED */
     unsigned long m_activeTimer; /**< time (ms) since LED was active */
     bool m_isActive; /**< active state of LED */
+    bool m_isCarryingRemainder; /**< remainder carrying state of LED */
+    bool m_isDeferringWrite; /**< deferred write state of LED */
+    unsigned int m_lateUpdateCount; /**< number of steps that were 
+                                    late */
+    unsigned long m_lostRemainderTime; /**< time (ms) dropped from late 
+                                       steps */
+    unsigned long m_maxOvershoot; /**< most time (ms) a step was late */
     
     /**
      * Stops blinking the LED. The blink timer is set to 0 and the 
-     * blinking state is set to inactive.
+     * blinking and pattern states are set to inactive.
      */
     void stopBlinkingLed();
 
+    /**
+     * Restarts the blink timer at the end of a blink or pattern 
+     * interval, recording how late the step was and carrying the 
+     * remainder if enabled.
+     */
+    void restartBlinkTimer(unsigned long interval);
+
     /**
      * Activates the LED. Increments the active
      * timer during each loop.
@@ -139,6 +307,29 @@ class DigitalLed {
      * Toggles the pin state from LOW to HIGH or from HIGH to LOW.
      */
     void switchLedPinState();
+
+    /**
+     * Starts showing the pattern from its first slot. The blink timer
+     * is kept, so a remainder carried from the last slot or gap counts
+     * toward the first slot.
+     */
+    void startPattern(unsigned long pattern, byte patternLength);
+
+    /**
+     * Sets the pin state to the pattern bit of the current slot.
+     */
+    void showPatternSlot();
+
+    /**
+     * Writes the pin state to the LED pin and calls the write observer,
+     * unless writes are deferred.
+     */
+    void writeLedPin();
+
+    /**
+     * Calls the write observer, if any, with the LED pin state.
+     */
+    void notifyWriteObserver();
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,149 @@
+// Function definitions for the AnimationPlayer class.
+
+// @author Janette H. Griggs
+// @version 1.1 10/19/26
+
+#include "AnimationPlayer.h"
+
+AnimationPlayer::AnimationPlayer() {
+  m_animation = NULL;
+  m_stepIndex = 0;
+  m_stepTimer = 0L;
+  m_step = animationEnd();
+}
+
+const AnimationStep* AnimationPlayer::getAnimation() const {
+  return m_animation;
+}
+
+byte AnimationPlayer::getStepIndex() const {
+  return m_stepIndex;
+}
+
+unsigned long AnimationPlayer::getStepTimer() const {
+  return m_stepTimer;
+}
+
+const AnimationStep& AnimationPlayer::getStep() const {
+  return m_step;
+}
+
+void AnimationPlayer::showAnimationLed(unsigned long deltaMillis,
+                                       const AnimationStep* animation,
+                                       AnalogLed& led) {
+  // Start each step with a new brightness change mode, so a blink or
+  // fade step starts from its beginning.
+  if (updateStep(deltaMillis, animation)) {
+    led.stopChangingBrightness();
+  }
+
+  if (m_step.opcode == ANIMATION_HOLD) {
+    led.showSteadyLed(deltaMillis);
+  } else if (m_step.opcode == ANIMATION_OFF) {
+    led.stopChangingBrightness();
+    led.activateLed(deltaMillis);
+    led.setToMinBrightness();
+  } else if (m_step.opcode == ANIMATION_BLINK) {
+    led.showBlinkingLed(deltaMillis, m_step.interval);
+  } else if (m_step.opcode == ANIMATION_FADE_IN) {
+    led.showFadingInLed(deltaMillis, m_step.interval);
+  } else if (m_step.opcode == ANIMATION_FADE_OUT) {
+    led.showFadingOutLed(deltaMillis, m_step.interval);
+  } else if (m_step.opcode == ANIMATION_FADE_IN_OUT) {
+    led.showFadingInOutLed(deltaMillis, m_step.interval);
+  } else {
+    led.activateLed(deltaMillis);
+  }
+}
+
+void AnimationPlayer::showAnimationLed(unsigned long deltaMillis,
+                                       const AnimationStep* animation,
+                                       DigitalLed& led) {
+  // Start each step with the blink timer at 0, so a blink step starts
+  // from its beginning.
+  if (updateStep(deltaMillis, animation)) {
+    led.stopBlinkingLed();
+  }
+
+  if (m_step.opcode == ANIMATION_HOLD || 
+      m_step.opcode == ANIMATION_FADE_IN ||
+      m_step.opcode == ANIMATION_FADE_OUT || 
+      m_step.opcode == ANIMATION_FADE_IN_OUT) {
+    led.showSteadyLed(deltaMillis);
+  } else if (m_step.opcode == ANIMATION_OFF) {
+    led.stopBlinkingLed();
+    led.activateLed(deltaMillis);
+    led.turnOffLed();
+  } else if (m_step.opcode == ANIMATION_BLINK) {
+    led.showBlinkingLed(deltaMillis, m_step.interval);
+  } else {
+    led.activateLed(deltaMillis);
+  }
+}
+
+bool AnimationPlayer::updateStep(unsigned long deltaMillis,
+                                 const AnimationStep* animation) {
+  bool isNewStep = false;
+  unsigned long stepTime;
+
+  if (m_animation != animation) {
+    m_animation = animation;
+    m_stepIndex = 0;
+    m_stepTimer = 0L;
+    readStep();
+    isNewStep = true;
+  } else if (m_step.opcode != ANIMATION_END) {
+    m_stepTimer += deltaMillis;
+    stepTime = calculateStepTime();
+
+    // Keep the time the step ran over, so the next step ends on time.
+    if (m_stepTimer >= stepTime) {
+      m_stepIndex++;
+      m_stepTimer -= stepTime;
+      readStep();
+      isNewStep = true;
+    }
+  }
+
+  return isNewStep;
+}
+
+void AnimationPlayer::resetAnimation() {
+  m_animation = NULL;
+  m_stepIndex = 0;
+  m_stepTimer = 0L;
+  m_step = animationEnd();
+}
+
+AnimationPlayer::~AnimationPlayer() {
+
+}
+
+void AnimationPlayer::readStep() {
+  if (pgm_read_byte(&m_animation[m_stepIndex].opcode) == 
+      ANIMATION_RESTART) {
+    m_stepIndex = 0;
+  }
+
+  m_step.opcode = pgm_read_byte(&m_animation[m_stepIndex].opcode);
+  m_step.count = pgm_read_byte(&m_animation[m_stepIndex].count);
+  m_step.interval = pgm_read_word(&m_animation[m_stepIndex].interval);
+}
+
+unsigned long AnimationPlayer::calculateStepTime() const {
+  unsigned long stepTime = 0L;
+
+  if (m_step.opcode == ANIMATION_HOLD || 
+      m_step.opcode == ANIMATION_OFF) {
+    stepTime = m_step.interval;
+  } else if (m_step.opcode == ANIMATION_FADE_IN || 
+             m_step.opcode == ANIMATION_FADE_OUT) {
+    stepTime = (unsigned long) m_step.interval * m_step.count;
+  } else if (m_step.opcode == ANIMATION_BLINK || 
+             m_step.opcode == ANIMATION_FADE_IN_OUT) {
+    // One blink or fade in and out takes two intervals.
+    stepTime = 2UL * m_step.interval * m_step.count;
+  }
+
+  return stepTime;
+}
@@ -0,0 +1,141 @@
+/**
+ * AnimationPlayer class.
+ *
+ * This class plays an LED animation stored in flash (see 
+ * LedAnimation.h) on an AnalogLed or DigitalLed passed by reference. 
+ * Each loop, it advances the step timer and reads the next step from
+ * flash when the current one is done, and shows the step with the 
+ * LED's usual blinking and fading functions. The LEDs themselves know
+ * nothing about animations, so only LEDs that are animated need a 
+ * player. Use one player per animated LED.
+ *
+ * The time by which a step ran over is carried into the next step, so
+ * the steps of a repeating animation don't drift from the loop time.
+ *
+ * Example:
+ *   AnalogLed led(3);
+ *   AnimationPlayer player;
+ *   // In loop(): player.showAnimationLed(deltaMillis, startup, led);
+ *
+ * @author Janette H. Griggs
+ * @version 1.1 10/19/26
+ */
+
+#ifndef AnimationPlayer_h
+  #define AnimationPlayer_h
+
+#ifndef __AVR_ATmega328P__
+  #define __AVR_ATmega328P__
+#endif
+#ifndef Arduino_h
+  #include <Arduino.h>
+#endif
+#ifndef LedAnimation_h
+  #include "LedAnimation.h"
+#endif
+#ifndef AnalogLed_h
+  #include <AnalogLed.h>
+#endif
+#ifndef DigitalLed_h
+  #include <DigitalLed.h>
+#endif
+
+class AnimationPlayer {
+  public:
+    /**
+     * Constructor.
+     */
+    AnimationPlayer();
+
+    /**
+     * Returns the animation being played.
+     * @return The animation, or NULL if none.
+     */
+    const AnimationStep* getAnimation() const;
+
+    /**
+     * Returns the index of the current step.
+     * @return The step index.
+     */
+    byte getStepIndex() const;
+
+    /**
+     * Returns the time (in ms) since the current step started.
+     * @return The step timer.
+     */
+    unsigned long getStepTimer() const;
+
+    /**
+     * Returns the current step.
+     * @return The current step.
+     */
+    const AnimationStep& getStep() const;
+
+    /**
+     * Shows an animation built with the functions in LedAnimation.h on
+     * an LED, one step after the other. A hold step shows the maximum 
+     * brightness, and an off step shows the minimum brightness. 
+     * After an end step, the LED stays as the previous step left it.
+     * NOTE: Call this function during each loop to maintain the 
+     * animation. Call resetAnimation() to start the animation over.
+     * @param deltaMillis The change in time (ms) from the previous loop.
+     * @param animation The animation steps in flash (PROGMEM).
+     * @param led The LED to show the animation on.
+     */
+    void showAnimationLed(unsigned long deltaMillis,
+                          const AnimationStep* animation, AnalogLed& led);
+
+    /**
+     * Shows an animation built with the functions in LedAnimation.h on
+     * an LED, one step after the other. Fading steps are shown as a 
+     * steady LED. After an end step, the LED stays as the previous step
+     * left it.
+     * NOTE: Call this function during each loop to maintain the 
+     * animation. Call resetAnimation() to start the animation over.
+     * @param deltaMillis The change in time (ms) from the previous loop.
+     * @param animation The animation steps in flash (PROGMEM).
+     * @param led The LED to show the animation on.
+     */
+    void showAnimationLed(unsigned long deltaMillis,
+                          const AnimationStep* animation, DigitalLed& led);
+
+    /**
+     * Advances the animation. A different animation than the one 
+     * being played starts from its first step. The time by which the
+     * current step ran over is carried into the next step.
+     * @param deltaMillis The change in time (ms) from the previous loop.
+     * @param animation The animation in flash.
+     * @return The truth value of whether a new step has started.
+     */
+    bool updateStep(unsigned long deltaMillis, 
+                    const AnimationStep* animation);
+
+    /**
+     * Stops playing the animation, so the next update starts it from
+     * its first step.
+     */
+    void resetAnimation();
+
+    /**
+     * Destructor.
+     */
+    ~AnimationPlayer();
+  private:
+    const AnimationStep* m_animation; /**< animation in flash */
+    byte m_stepIndex; /**< index of the current step */
+    unsigned long m_stepTimer; /**< time (ms) since the step started */
+    AnimationStep m_step; /**< copy of the current step */
+
+    /**
+     * Reads the current step from flash, following a restart step back
+     * to the first step.
+     */
+    void readStep();
+
+    /**
+     * Calculates the time (ms) the current step takes.
+     */
+    unsigned long calculateStepTime() const;
+};
+
+#endif
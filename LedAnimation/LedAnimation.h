@@ -0,0 +1,128 @@
+/**
+ * LED animation steps.
+ *
+ * An animation is an array of steps, such as "fade in for 500 ms, 
+ * hold for 1 s, blink 3 times at 100 ms, fade out for 500 ms". The
+ * steps are built at compile time with the constexpr functions below
+ * and the array is placed in flash with PROGMEM, so showing an 
+ * animation with AnimationPlayer::showAnimationLed() needs no parsing,
+ * heap or RAM copy.
+ * Each step is 4 bytes, and intervals are at most 65535 ms.
+ *
+ * Example:
+ *   const AnimationStep startup[] PROGMEM = {
+ *     animationFadeIn(500),
+ *     animationHold(1000),
+ *     animationBlink(100, 3),
+ *     animationFadeOut(500),
+ *     animationRestart()
+ *   };
+ *
+ * @author Janette H. Griggs
+ * @version 1.1 10/19/26
+ */
+
+#ifndef LedAnimation_h
+  #define LedAnimation_h
+
+#ifndef __AVR_ATmega328P__
+  #define __AVR_ATmega328P__
+#endif
+#ifndef Arduino_h
+  #include <Arduino.h>
+#endif
+
+enum AnimationOpcode {ANIMATION_END, ANIMATION_RESTART, ANIMATION_HOLD,
+                      ANIMATION_OFF, ANIMATION_BLINK, ANIMATION_FADE_IN,
+                      ANIMATION_FADE_OUT, ANIMATION_FADE_IN_OUT};
+
+struct AnimationStep {
+  byte opcode; /**< animation opcode of the step */
+  byte count; /**< number of blinks or fades */
+  unsigned int interval; /**< interval (ms) of the step */
+};
+
+/**
+ * Returns a step that turns the LED on for an interval.
+ * @param holdInterval The interval (ms).
+ * @return The animation step.
+ */
+constexpr AnimationStep animationHold(unsigned int holdInterval) {
+  return AnimationStep {ANIMATION_HOLD, 1, holdInterval};
+}
+
+/**
+ * Returns a step that turns the LED off for an interval.
+ * @param offInterval The interval (ms).
+ * @return The animation step.
+ */
+constexpr AnimationStep animationOff(unsigned int offInterval) {
+  return AnimationStep {ANIMATION_OFF, 1, offInterval};
+}
+
+/**
+ * Returns a step that blinks the LED a number of times.
+ * @param blinkInterval The interval (ms) between the maximum and 
+ * minimum brightness.
+ * @param count The number of blinks.
+ * @return The animation step.
+ */
+constexpr AnimationStep animationBlink(unsigned int blinkInterval, 
+                                       byte count) {
+  return AnimationStep {ANIMATION_BLINK, count, blinkInterval};
+}
+
+/**
+ * Returns a step that fades in the LED a number of times.
+ * @param fadeInterval The interval (ms) between the minimum and
+ * maximum brightness.
+ * @param count The number of fades.
+ * @return The animation step.
+ */
+constexpr AnimationStep animationFadeIn(unsigned int fadeInterval, 
+                                        byte count = 1) {
+  return AnimationStep {ANIMATION_FADE_IN, count, fadeInterval};
+}
+
+/**
+ * Returns a step that fades out the LED a number of times.
+ * @param fadeInterval The interval (ms) between the maximum and
+ * minimum brightness.
+ * @param count The number of fades.
+ * @return The animation step.
+ */
+constexpr AnimationStep animationFadeOut(unsigned int fadeInterval, 
+                                         byte count = 1) {
+  return AnimationStep {ANIMATION_FADE_OUT, count, fadeInterval};
+}
+
+/**
+ * Returns a step that fades the LED in and out a number of times.
+ * @param fadeInterval The interval (ms) between the minimum and
+ * maximum brightness.
+ * @param count The number of fades in and out.
+ * @return The animation step.
+ */
+constexpr AnimationStep animationFadeInOut(unsigned int fadeInterval, 
+                                           byte count = 1) {
+  return AnimationStep {ANIMATION_FADE_IN_OUT, count, fadeInterval};
+}
+
+/**
+ * Returns a step that starts the animation over from the first step.
+ * @return The animation step.
+ */
+constexpr AnimationStep animationRestart() {
+  return AnimationStep {ANIMATION_RESTART, 0, 0};
+}
+
+/**
+ * Returns a step that ends the animation, keeping the LED as the 
+ * previous step left it.
+ * @return The animation step.
+ */
+constexpr AnimationStep animationEnd() {
+  return AnimationStep {ANIMATION_END, 0, 0};
+}
+
+#endif
@@ -0,0 +1,318 @@
+// Function definitions for the LedMatrix class.
+
+// @author Janette H. Griggs
+// @version 1.3 10/19/26
+
+#include "LedMatrix.h"
+#include <util/atomic.h>
+
+LedMatrix* LedMatrix::s_scanningMatrix = NULL;
+
+ISR(TIMER1_COMPA_vect) {
+  LedMatrix::scanNextStep();
+}
+
+LedMatrix::LedMatrix(const byte rowPinNumbers[],
+                     const byte columnPinNumbers[]) {
+  for (byte i = 0; i < MATRIX_SIZE; i++) {
+    m_rowRegisters[i] = 
+        portOutputRegister(digitalPinToPort(rowPinNumbers[i]));
+    m_rowMasks[i] = digitalPinToBitMask(rowPinNumbers[i]);
+    m_columnRegisters[i] = 
+        portOutputRegister(digitalPinToPort(columnPinNumbers[i]));
+    m_columnMasks[i] = digitalPinToBitMask(columnPinNumbers[i]);
+
+    digitalWrite(rowPinNumbers[i], LOW);
+    digitalWrite(columnPinNumbers[i], HIGH);
+    pinMode(rowPinNumbers[i], OUTPUT);
+    pinMode(columnPinNumbers[i], OUTPUT);
+  }
+
+  m_shownBuffer = 0;
+  m_isFrameReady = false;
+  m_scanRow = 0;
+  m_scanBit = 0;
+  m_frameCount = 0;
+  m_isrTicks = 0L;
+  m_brightnessChangeTimer = 0L;
+  m_statisticsTimer = 0L;
+  m_refreshRate = 0;
+  m_isrLoad = 0;
+
+  resetAllPixels();
+
+  for (byte i = 0; i < MATRIX_SIZE; i++) {
+    for (byte j = 0; j < BCM_BITS; j++) {
+      m_frameBuffers[0][i][j] = 0;
+      m_frameBuffers[1][i][j] = 0;
+    }
+  }
+}
+
+byte LedMatrix::getPixelBrightness(byte row, byte column) const {
+  return m_pixelBrightness[row][column];
+}
+
+BrightnessChangeMode LedMatrix::getPixelMode(byte row, 
+                                             byte column) const {
+  return (BrightnessChangeMode) m_pixelModes[row][column];
+}
+
+unsigned long LedMatrix::getBrightnessChangeTimer() const {
+  return m_brightnessChangeTimer;
+}
+
+unsigned int LedMatrix::getRefreshRate() const {
+  return m_refreshRate;
+}
+
+byte LedMatrix::getIsrLoad() const {
+  return m_isrLoad;
+}
+
+void LedMatrix::showSteadyPixel(byte row, byte column, byte brightness) {
+  setPixel(row, column, brightness, NONE);
+}
+
+void LedMatrix::showBlinkingPixel(byte row, byte column,
+                                  byte brightness) {
+  setPixel(row, column, brightness, BLINK);
+}
+
+void LedMatrix::showFadingInPixel(byte row, byte column,
+                                  byte brightness) {
+  setPixel(row, column, brightness, FADE_IN);
+}
+
+void LedMatrix::showFadingOutPixel(byte row, byte column,
+                                   byte brightness) {
+  setPixel(row, column, brightness, FADE_OUT);
+}
+
+void LedMatrix::showFadingInOutPixel(byte row, byte column,
+                                     byte brightness) {
+  setPixel(row, column, brightness, FADE_IN_OUT);
+}
+
+void LedMatrix::resetPixel(byte row, byte column) {
+  setPixel(row, column, 0, NONE);
+}
+
+void LedMatrix::resetAllPixels() {
+  for (byte i = 0; i < MATRIX_SIZE; i++) {
+    for (byte j = 0; j < MATRIX_SIZE; j++) {
+      setPixel(i, j, 0, NONE);
+    }
+  }
+}
+
+void LedMatrix::updateMatrix(unsigned long deltaMillis,
+                             unsigned long changeInterval) {
+  m_brightnessChangeTimer += deltaMillis;
+
+  if (m_brightnessChangeTimer >= 2 * changeInterval) {
+    if (changeInterval > 0) {
+      m_brightnessChangeTimer %= 2 * changeInterval;
+    } else {
+      m_brightnessChangeTimer = 0L;
+    }
+  }
+
+  if (!m_isFrameReady) {
+    drawFrame(changeInterval);
+
+    // The atomic block is also a compiler barrier, so the frame buffer
+    // stores can't be moved after the flag that hands the frame over.
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+      m_isFrameReady = true;
+    }
+  }
+
+  measureScanning(deltaMillis);
+}
+
+void LedMatrix::startScanning() {
+  s_scanningMatrix = this;
+  m_scanRow = MATRIX_SIZE - 1;
+  m_scanBit = BCM_BITS - 1;
+
+  // CTC mode with OCR1A as TOP and a prescaler of 8, i.e. 0.5 us
+  // ticks. The next step starts the first row of a frame.
+  TCCR1A = 0;
+  TCCR1B = _BV(WGM12) | _BV(CS11);
+  OCR1A = BCM_BASE_TICKS - 1;
+  TCNT1 = 0;
+  TIMSK1 |= _BV(OCIE1A);
+}
+
+void LedMatrix::stopScanning() {
+  TIMSK1 &= ~_BV(OCIE1A);
+  s_scanningMatrix = NULL;
+
+  for (byte i = 0; i < MATRIX_SIZE; i++) {
+    *m_rowRegisters[i] &= ~m_rowMasks[i];
+  }
+}
+
+void LedMatrix::scanNextStep() {
+  if (s_scanningMatrix != NULL) {
+    s_scanningMatrix->scanStep();
+  }
+}
+
+void LedMatrix::setPixel(byte row, byte column, byte brightness,
+                         BrightnessChangeMode mode) {
+  m_pixelBrightness[row][column] = brightness;
+  m_pixelModes[row][column] = mode;
+}
+
+byte LedMatrix::calculateLevel(byte mode,
+                               unsigned long changeInterval) const {
+  byte level = 255;
+  unsigned long changeTimer = m_brightnessChangeTimer;
+
+  if (changeInterval > 0) {
+    if (mode == BLINK) {
+      if (changeTimer >= changeInterval) {
+        level = 0;
+      }
+    } else if (mode == FADE_IN) {
+      level = changeTimer % changeInterval * 255 / changeInterval;
+    } else if (mode == FADE_OUT) {
+      level = 255 - changeTimer % changeInterval * 255 / changeInterval;
+    } else if (mode == FADE_IN_OUT) {
+      if (changeTimer >= changeInterval) {
+        changeTimer = 2 * changeInterval - changeTimer;
+      }
+
+      level = changeTimer * 255 / changeInterval;
+    }
+  }
+
+  return level;
+}
+
+void LedMatrix::drawFrame(unsigned long changeInterval) {
+  byte (*frame)[BCM_BITS] = m_frameBuffers[!m_shownBuffer];
+  byte levels[FADE_IN_OUT + 1];
+  unsigned int scaledBrightness;
+  byte brightness;
+
+  // The level (0 to 255) follows the same cycle for all pixels in a 
+  // mode, so it is calculated once per mode instead of once per pixel.
+  for (byte i = NONE; i <= FADE_IN_OUT; i++) {
+    levels[i] = calculateLevel(i, changeInterval);
+  }
+
+  for (byte i = 0; i < MATRIX_SIZE; i++) {
+    for (byte j = 0; j < BCM_BITS; j++) {
+      frame[i][j] = 0;
+    }
+
+    for (byte j = 0; j < MATRIX_SIZE; j++) {
+      // Rounded brightness * level / 255, with the division by 255 
+      // done as shifts. This is exact for all byte brightness and 
+      // level values. The product is unsigned, since 255 * 255 
+      // overflows a 16-bit int.
+      scaledBrightness = (unsigned int) m_pixelBrightness[i][j] * 
+                         levels[m_pixelModes[i][j]] + 127;
+      scaledBrightness = (scaledBrightness + 1 + 
+                          (scaledBrightness >> 8)) >> 8;
+      brightness = scaledBrightness >> (8 - BCM_BITS);
+
+      for (byte k = 0; k < BCM_BITS; k++) {
+        if (brightness & (1 << k)) {
+          frame[i][k] |= 1 << j;
+        }
+      }
+    }
+  }
+}
+
+void LedMatrix::measureScanning(unsigned long deltaMillis) {
+  unsigned int frameCount;
+  unsigned long isrTicks;
+  uint8_t oldSREG;
+
+  m_statisticsTimer += deltaMillis;
+
+  if (m_statisticsTimer >= 1000) {
+    // The counters are updated by the interrupt, so copy and clear
+    // them with interrupts off.
+    oldSREG = SREG;
+    cli();
+    frameCount = m_frameCount;
+    isrTicks = m_isrTicks;
+    m_frameCount = 0;
+    m_isrTicks = 0L;
+    SREG = oldSREG;
+
+    m_refreshRate = frameCount * 1000UL / m_statisticsTimer;
+
+    // A tick is 0.5 us, so the load in percent is the ticks divided by
+    // 20 times the time in ms.
+    m_isrLoad = isrTicks / (m_statisticsTimer * 20);
+    m_statisticsTimer = 0L;
+  }
+}
+
+void LedMatrix::writeColumns(byte columnBits) {
+  // The column bits are shifted out one at a time, since a shift by a
+  // variable amount is a loop on the AVR.
+  for (byte i = 0; i < MATRIX_SIZE; i++) {
+    if (columnBits & 1) {
+      *m_columnRegisters[i] &= ~m_columnMasks[i];
+    } else {
+      *m_columnRegisters[i] |= m_columnMasks[i];
+    }
+
+    columnBits >>= 1;
+  }
+}
+
+void LedMatrix::scanStep() {
+  byte scanBit = m_scanBit + 1;
+
+  if (scanBit >= BCM_BITS) {
+    scanBit = 0;
+  }
+
+  // Each bit is shown twice as long as the one before. The compare 
+  // value is set first, while TCNT1 is still well below it. Set after
+  // the pin writes, TCNT1 could already be past it, and Timer1 would
+  // count up to 0xFFFF and wrap, stalling the scan for about 32 ms.
+  OCR1A = (BCM_BASE_TICKS << scanBit) - 1;
+  m_scanBit = scanBit;
+
+  if (scanBit == 0) {
+    // Turn off the row before switching the columns, so no pixel of
+    // the next row shows in this one.
+    *m_rowRegisters[m_scanRow] &= ~m_rowMasks[m_scanRow];
+    m_scanRow++;
+
+    if (m_scanRow >= MATRIX_SIZE) {
+      m_scanRow = 0;
+      m_frameCount++;
+
+      if (m_isFrameReady) {
+        m_shownBuffer = !m_shownBuffer;
+        m_isFrameReady = false;
+      }
+    }
+
+    writeColumns(m_frameBuffers[m_shownBuffer][m_scanRow][0]);
+    *m_rowRegisters[m_scanRow] |= m_rowMasks[m_scanRow];
+  } else {
+    writeColumns(m_frameBuffers[m_shownBuffer][m_scanRow][scanBit]);
+  }
+
+  // TCNT1 counts from the compare match, so it is the time spent in 
+  // the interrupt.
+  m_isrTicks += TCNT1;
+}
+
+LedMatrix::~LedMatrix() {
+  if (s_scanningMatrix == this) {
+    stopScanning();
+  }
+}
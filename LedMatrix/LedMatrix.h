@@ -0,0 +1,272 @@
+/**
+ * LedMatrix class.
+ *
+ * This class drives an 8x8 matrix of single color LEDs on the Arduino
+ * Uno, with a brightness and a brightness change mode (steady,
+ * blinking or fading) for each pixel. The rows are shown one at a time
+ * from the Timer1 compare interrupt. Each row is shown once for each
+ * brightness bit, for a time in proportion to the bit's weight (binary
+ * code modulation), so 6 interrupts per row give 64 brightness levels
+ * with no PWM pins needed.
+ *
+ * The frame is drawn in the loop into one of two frame buffers while
+ * the interrupt shows the other. The buffers are only swapped at the
+ * start of a frame, so a frame is never shown half drawn. Each buffer
+ * holds one byte of column bits for each row and brightness bit.
+ *
+ * Unlike AnalogLed, a pixel has no change interval or timer of its
+ * own. All pixels share the interval passed to updateMatrix() and one
+ * brightness change timer, so all pixels in a mode blink or fade in
+ * step, and each pixel only needs its brightness and mode. A fade
+ * interval is the time from the minimum to the maximum brightness, and
+ * blinking pixels are on for one interval and off for the next.
+ *
+ * Row pins drive the anodes (active HIGH) and column pins the cathodes
+ * (active LOW) of the matrix. A whole row can draw more current than a
+ * pin can supply, so use row driver transistors for bright matrices.
+ *
+ * NOTE: Scanning uses Timer1, so analogWrite() can't be used on pins 9
+ * and 10, and AnalogLed::setPwmResolution() can't be used above 8 bits.
+ * The library defines the Timer1 compare A interrupt, so it can't be
+ * used in the same sketch as the Servo library. It is kept apart from
+ * the AnalogLed library, so sketches that only use AnalogLed don't
+ * define the interrupt.
+ *
+ * @author Janette H. Griggs
+ * @version 1.3 10/19/26
+ */
+
+#ifndef LedMatrix_h
+  #define LedMatrix_h
+
+#ifndef __AVR_ATmega328P__
+  #define __AVR_ATmega328P__
+#endif
+#ifndef Arduino_h
+  #include <Arduino.h>
+#endif
+#ifndef BrightnessChangeMode_h
+  #include <BrightnessChangeMode.h>
+#endif
+
+class LedMatrix {
+  public:
+    static const byte MATRIX_SIZE = 8; /**< number of rows and 
+                                       columns */
+    static const byte BCM_BITS = 6; /**< brightness bits shown */
+    static const unsigned int BCM_BASE_TICKS = 48; /**< Timer1 ticks 
+                                                   (0.5 us) the lowest
+                                                   brightness bit is 
+                                                   shown, longer than
+                                                   the interrupt 
+                                                   takes */
+
+    /**
+     * Constructor.
+     * Configures the row and column pins for output with all pixels
+     * turned off.
+     * @param rowPinNumbers The MATRIX_SIZE row pin numbers.
+     * @param columnPinNumbers The MATRIX_SIZE column pin numbers.
+     */
+    LedMatrix(const byte rowPinNumbers[], const byte columnPinNumbers[]);
+
+    /**
+     * Returns the maximum brightness of a pixel.
+     * @param row The row of the pixel.
+     * @param column The column of the pixel.
+     * @return The brightness, between 0 and 255, inclusive.
+     */
+    byte getPixelBrightness(byte row, byte column) const;
+
+    /**
+     * Returns the brightness change mode of a pixel.
+     * @param row The row of the pixel.
+     * @param column The column of the pixel.
+     * @return The brightness change mode.
+     */
+    BrightnessChangeMode getPixelMode(byte row, byte column) const;
+
+    /**
+     * Returns the time (in ms) in the brightness change cycle, which 
+     * is two change intervals long.
+     * @return The brightness change timer.
+     */
+    unsigned long getBrightnessChangeTimer() const;
+
+    /**
+     * Returns the number of frames shown per second, measured over the
+     * last second.
+     * @return The refresh rate.
+     */
+    unsigned int getRefreshRate() const;
+
+    /**
+     * Returns the time spent in the scan interrupt over the last 
+     * second, in percent.
+     * @return The interrupt load.
+     */
+    byte getIsrLoad() const;
+
+    /**
+     * Shows a pixel at a steady brightness.
+     * @param row The row of the pixel.
+     * @param column The column of the pixel.
+     * @param brightness The brightness, between 0 and 255, inclusive.
+     */
+    void showSteadyPixel(byte row, byte column, byte brightness);
+
+    /**
+     * Blinks a pixel, in step with the other blinking pixels.
+     * @param row The row of the pixel.
+     * @param column The column of the pixel.
+     * @param brightness The brightness, between 0 and 255, inclusive.
+     */
+    void showBlinkingPixel(byte row, byte column, byte brightness);
+
+    /**
+     * Fades in a pixel in a repeating loop, in step with the other
+     * pixels fading in.
+     * @param row The row of the pixel.
+     * @param column The column of the pixel.
+     * @param brightness The maximum brightness, between 0 and 255, 
+     * inclusive.
+     */
+    void showFadingInPixel(byte row, byte column, byte brightness);
+
+    /**
+     * Fades out a pixel in a repeating loop, in step with the other
+     * pixels fading out.
+     * @param row The row of the pixel.
+     * @param column The column of the pixel.
+     * @param brightness The maximum brightness, between 0 and 255, 
+     * inclusive.
+     */
+    void showFadingOutPixel(byte row, byte column, byte brightness);
+
+    /**
+     * Fades a pixel in and out repeatedly, in step with the other
+     * pixels fading in and out.
+     * @param row The row of the pixel.
+     * @param column The column of the pixel.
+     * @param brightness The maximum brightness, between 0 and 255, 
+     * inclusive.
+     */
+    void showFadingInOutPixel(byte row, byte column, byte brightness);
+
+    /**
+     * Turns off a pixel.
+     * @param row The row of the pixel.
+     * @param column The column of the pixel.
+     */
+    void resetPixel(byte row, byte column);
+
+    /**
+     * Turns off all the pixels.
+     */
+    void resetAllPixels();
+
+    /**
+     * Advances the brightness change timer, draws the next frame and
+     * measures the refresh rate and interrupt load. A frame is not 
+     * drawn while the previous one hasn't been shown yet.
+     * NOTE: Call this function during each loop.
+     * @param deltaMillis The change in time (ms) from the previous loop.
+     * @param changeInterval The interval (in ms) between the maximum 
+     * brightness and minimum brightness of blinking and fading pixels,
+     * shared by all pixels.
+     */
+    void updateMatrix(unsigned long deltaMillis,
+                      unsigned long changeInterval);
+
+    /**
+     * Starts showing the frames from the Timer1 compare interrupt, at
+     * about 80 frames per second.
+     */
+    void startScanning();
+
+    /**
+     * Stops the interrupt and turns off all the rows.
+     */
+    void stopScanning();
+
+    /**
+     * Shows the next brightness bit or row of the scanning matrix.
+     * NOTE: This is called from the Timer1 compare interrupt.
+     */
+    static void scanNextStep();
+
+    /**
+     * Destructor.
+     */
+    ~LedMatrix();
+  private:
+    volatile uint8_t* m_rowRegisters[MATRIX_SIZE]; /**< row port output
+                                                   registers */
+    byte m_rowMasks[MATRIX_SIZE]; /**< row port bits */
+    volatile uint8_t* m_columnRegisters[MATRIX_SIZE]; /**< column port 
+                                                      output 
+                                                      registers */
+    byte m_columnMasks[MATRIX_SIZE]; /**< column port bits */
+    byte m_pixelBrightness[MATRIX_SIZE][MATRIX_SIZE]; /**< maximum 
+                                                      brightness of 
+                                                      each pixel */
+    byte m_pixelModes[MATRIX_SIZE][MATRIX_SIZE]; /**< 
+                                                 BrightnessChangeMode
+                                                 of each pixel */
+    byte m_frameBuffers[2][MATRIX_SIZE][BCM_BITS]; /**< column bits of
+                                                   each row and 
+                                                   brightness bit */
+    volatile byte m_shownBuffer; /**< frame buffer being shown */
+    volatile bool m_isFrameReady; /**< other frame buffer is drawn */
+    volatile byte m_scanRow; /**< row being shown */
+    volatile byte m_scanBit; /**< brightness bit being shown */
+    volatile unsigned int m_frameCount; /**< frames shown since the 
+                                        last measurement */
+    volatile unsigned long m_isrTicks; /**< Timer1 ticks spent in the 
+                                       interrupt since the last 
+                                       measurement */
+    unsigned long m_brightnessChangeTimer; /**< time (ms) in the 
+                                           brightness change cycle */
+    unsigned long m_statisticsTimer; /**< time (ms) since the last
+                                     measurement */
+    unsigned int m_refreshRate; /**< frames shown per second */
+    byte m_isrLoad; /**< interrupt load (%) */
+
+    static LedMatrix* s_scanningMatrix; /**< matrix shown by the 
+                                        interrupt */
+
+    /**
+     * Sets the brightness and mode of a pixel.
+     */
+    void setPixel(byte row, byte column, byte brightness,
+                  BrightnessChangeMode mode);
+
+    /**
+     * Returns the level (0 to 255) that the brightness of the pixels
+     * in a mode is scaled by at the current time in the brightness 
+     * change cycle.
+     */
+    byte calculateLevel(byte mode, unsigned long changeInterval) const;
+
+    /**
+     * Draws the pixels into the frame buffer that isn't shown.
+     */
+    void drawFrame(unsigned long changeInterval);
+
+    /**
+     * Updates the refresh rate and interrupt load once per second.
+     */
+    void measureScanning(unsigned long deltaMillis);
+
+    /**
+     * Writes the column pins for a row and brightness bit.
+     */
+    void writeColumns(byte columnBits);
+
+    /**
+     * Shows the next brightness bit or row.
+     */
+    void scanStep();
+};
+
+#endif
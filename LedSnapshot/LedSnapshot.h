@@ -0,0 +1,25 @@
+// LedSnapshot struct for saving the state of an AnalogLed
+// or a DigitalLed, e.g. in EEPROM with LedSnapshotStore.
+
+// @author Janette H. Griggs
+// @version 1.0 10/19/26
+
+#ifndef LedSnapshot_h
+  #define LedSnapshot_h
+
+#ifndef __AVR_ATmega328P__
+  #define __AVR_ATmega328P__
+#endif
+#ifndef Arduino_h
+  #include <Arduino.h>
+#endif
+
+struct LedSnapshot {
+  byte mode; /**< brightness change mode, or blinking state */
+  byte flags; /**< active state and direction of brightness change */
+  unsigned int brightness; /**< current brightness, or pin state */
+  unsigned long changeTimer; /**< brightness change or blink timer (ms) */
+  unsigned long activeTimer; /**< time (ms) since LED was active */
+};
+
+#endif
@@ -0,0 +1,156 @@
+// Function definitions for the LedSnapshotStore class.
+
+// @author Janette H. Griggs
+// @version 1.1 10/19/26
+
+#include "LedSnapshotStore.h"
+#include <avr/eeprom.h>
+#include <util/crc16.h>
+
+LedSnapshotStore::LedSnapshotStore(unsigned int eepromAddress,
+                                   byte snapshotCount,
+                                   byte slotCount) {
+  unsigned int sequence;
+
+  m_eepromAddress = eepromAddress;
+  m_snapshotCount = snapshotCount;
+  m_slotCount = slotCount;
+  m_currentSlot = 0;
+  m_sequence = 0;
+  m_hasRecord = false;
+  m_saveCount = 0;
+
+  // The latest record is the valid one with the highest sequence
+  // number. The difference is compared as signed, so the sequence 
+  // number can wrap around.
+  for (byte slot = 0; slot < m_slotCount; slot++) {
+    if (checkRecord(slot)) {
+      eeprom_read_block(&sequence, 
+                        (const void*) calculateSlotAddress(slot),
+                        sizeof(sequence));
+
+      if (!m_hasRecord || (int) (sequence - m_sequence) > 0) {
+        m_currentSlot = slot;
+        m_sequence = sequence;
+        m_hasRecord = true;
+      }
+    }
+  }
+}
+
+unsigned int LedSnapshotStore::getRecordSize() const {
+  // Sequence number, snapshots and CRC.
+  return sizeof(unsigned int) + m_snapshotCount * sizeof(LedSnapshot) + 
+         sizeof(unsigned int);
+}
+
+bool LedSnapshotStore::getHasRecord() const {
+  return m_hasRecord;
+}
+
+unsigned int LedSnapshotStore::getSaveCount() const {
+  return m_saveCount;
+}
+
+bool LedSnapshotStore::saveSnapshots(const LedSnapshot snapshots[],
+                                     bool isForced) {
+  bool isChanged = isForced || !m_hasRecord;
+  bool isSaved = false;
+  unsigned int crc = 0xFFFF;
+  unsigned int address;
+  const byte* data;
+
+  for (byte i = 0; i < m_snapshotCount && !isChanged; i++) {
+    isChanged = hasMeaningfulChange(snapshots[i], i);
+  }
+
+  // A store without slots never saves.
+  if (isChanged && m_slotCount > 0) {
+    // Write the next slot, leaving the latest record intact until the
+    // new one is complete.
+    m_currentSlot = (m_currentSlot + 1) % m_slotCount;
+    m_sequence++;
+    address = calculateSlotAddress(m_currentSlot);
+
+    data = (const byte*) &m_sequence;
+    for (byte i = 0; i < sizeof(m_sequence); i++) {
+      crc = _crc16_update(crc, data[i]);
+    }
+
+    data = (const byte*) snapshots;
+    for (unsigned int i = 0; i < m_snapshotCount * sizeof(LedSnapshot); 
+         i++) {
+      crc = _crc16_update(crc, data[i]);
+    }
+
+    eeprom_update_block(&m_sequence, (void*) address, sizeof(m_sequence));
+    address += sizeof(m_sequence);
+    eeprom_update_block(snapshots, (void*) address, 
+                        m_snapshotCount * sizeof(LedSnapshot));
+    address += m_snapshotCount * sizeof(LedSnapshot);
+    eeprom_update_block(&crc, (void*) address, sizeof(crc));
+
+    m_hasRecord = true;
+    m_saveCount++;
+    isSaved = true;
+  }
+
+  return isSaved;
+}
+
+bool LedSnapshotStore::restoreSnapshots(LedSnapshot snapshots[]) const {
+  if (m_hasRecord) {
+    eeprom_read_block(snapshots, 
+        (const void*) (calculateSlotAddress(m_currentSlot) + 
+                       sizeof(m_sequence)),
+        m_snapshotCount * sizeof(LedSnapshot));
+  }
+
+  return m_hasRecord;
+}
+
+LedSnapshotStore::~LedSnapshotStore() {
+
+}
+
+unsigned int LedSnapshotStore::calculateSlotAddress(byte slot) const {
+  return m_eepromAddress + slot * getRecordSize();
+}
+
+bool LedSnapshotStore::checkRecord(byte slot) const {
+  unsigned int address = calculateSlotAddress(slot);
+  unsigned int dataSize = getRecordSize() - sizeof(unsigned int);
+  unsigned int crc = 0xFFFF;
+  unsigned int recordCrc;
+
+  for (unsigned int i = 0; i < dataSize; i++) {
+    crc = _crc16_update(crc, eeprom_read_byte((const uint8_t*) 
+                                              (address + i)));
+  }
+
+  eeprom_read_block(&recordCrc, (const void*) (address + dataSize),
+                    sizeof(recordCrc));
+
+  return crc == recordCrc;
+}
+
+bool LedSnapshotStore::hasMeaningfulChange(const LedSnapshot& snapshot,
+                                           byte snapshotIndex) const {
+  LedSnapshot savedSnapshot;
+
+  eeprom_read_block(&savedSnapshot, 
+      (const void*) (calculateSlotAddress(m_currentSlot) + 
+                     sizeof(m_sequence) + 
+                     snapshotIndex * sizeof(LedSnapshot)),
+      sizeof(LedSnapshot));
+
+  // Timers and the brightness of a blinking or fading LED change 
+  // every loop, so they alone don't cause a save. Neither does the 
+  // direction in the other flag bits, which changes with every blink 
+  // or fade turnaround, so only the active state in bit 0 is compared.
+  // A mode of 0 means the LED is neither blinking nor fading.
+  return snapshot.mode != savedSnapshot.mode || 
+         (snapshot.flags & 1) != (savedSnapshot.flags & 1) ||
+         (snapshot.mode == 0 && 
+          snapshot.brightness != savedSnapshot.brightness);
+}
@@ -0,0 +1,138 @@
+/**
+ * LedSnapshotStore class.
+ *
+ * This class saves the snapshots of a set of LEDs in EEPROM, so they
+ * can resume their blinking and fading after a reset. 
+ *
+ * Each save is a record of a sequence number, the snapshots and a 
+ * CRC. Records are written to the next of several slots in turn, which
+ * spreads the wear over the slots, and the record with the highest
+ * sequence number and a valid CRC is restored. If power is lost while
+ * a record is written, its CRC is invalid and the previous record is
+ * restored instead.
+ *
+ * To save EEPROM writes, snapshots are only saved when the mode or
+ * active state of an LED has changed, or the brightness of an LED that
+ * is not blinking or fading has changed. So only the mode, active 
+ * state and steady brightness of a restored LED are current. Its blink
+ * or fade timer, direction and active timer are those of the last 
+ * save, so a blinking or fading LED resumes in the phase it had then,
+ * not the phase it had at the reset. If saveSnapshots() is called
+ * each loop, that is the start of the blink or fade.
+ *
+ * Example:
+ *   LedSnapshot snapshots[2];
+ *   LedSnapshotStore store(0, 2, 4);
+ *   // In setup(), so the LEDs resume from the first loop:
+ *   if (store.restoreSnapshots(snapshots)) {
+ *     statusLed.restoreSnapshot(snapshots[0]);
+ *     powerLed.restoreSnapshot(snapshots[1]);
+ *   }
+ *   // In loop(), after the LEDs are updated:
+ *   statusLed.saveSnapshot(snapshots[0]);
+ *   powerLed.saveSnapshot(snapshots[1]);
+ *   store.saveSnapshots(snapshots);
+ *
+ * @author Janette H. Griggs
+ * @version 1.2 10/19/26
+ */
+
+#ifndef LedSnapshotStore_h
+  #define LedSnapshotStore_h
+
+#ifndef __AVR_ATmega328P__
+  #define __AVR_ATmega328P__
+#endif
+#ifndef Arduino_h
+  #include <Arduino.h>
+#endif
+#ifndef LedSnapshot_h
+  #include "LedSnapshot.h"
+#endif
+
+class LedSnapshotStore {
+  public:
+    /**
+     * Constructor.
+     * Finds the latest record in EEPROM.
+     * @param eepromAddress The EEPROM address of the first slot.
+     * @param snapshotCount The number of snapshots in each record.
+     * @param slotCount The number of slots to spread the records over.
+     * The store takes slotCount * getRecordSize() bytes of EEPROM. A 
+     * store with 0 slots never saves.
+     */
+    LedSnapshotStore(unsigned int eepromAddress, byte snapshotCount,
+                     byte slotCount);
+
+    /**
+     * Returns the size (in bytes) of one record in EEPROM.
+     * @return The record size.
+     */
+    unsigned int getRecordSize() const;
+
+    /**
+     * Returns whether a valid record was found in EEPROM or saved.
+     * @return The truth value of whether there is a record.
+     */
+    bool getHasRecord() const;
+
+    /**
+     * Returns the number of records saved since construction.
+     * @return The save count.
+     */
+    unsigned int getSaveCount() const;
+
+    /**
+     * Saves the snapshots if any of them has changed in a meaningful
+     * way since the last save, i.e. in its mode, its active state or 
+     * the brightness of a steady LED. The blink phase and fade 
+     * direction are not meaningful changes, so a blinking LED doesn't
+     * cause a save with every blink.
+     * @param snapshots The array of snapshots.
+     * @param isForced Whether to save even if nothing meaningful has
+     * changed, e.g. to store the current timers before a planned 
+     * reset.
+     * @return The truth value of whether the snapshots were saved.
+     */
+    bool saveSnapshots(const LedSnapshot snapshots[], 
+                       bool isForced = false);
+
+    /**
+     * Restores the snapshots from the latest record.
+     * @param snapshots The array to restore the snapshots into.
+     * @return The truth value of whether a valid record was found.
+     */
+    bool restoreSnapshots(LedSnapshot snapshots[]) const;
+
+    /**
+     * Destructor.
+     */
+    ~LedSnapshotStore();
+  private:
+    unsigned int m_eepromAddress; /**< EEPROM address of the first slot */
+    byte m_snapshotCount; /**< number of snapshots per record */
+    byte m_slotCount; /**< number of slots */
+    byte m_currentSlot; /**< slot of the latest record */
+    unsigned int m_sequence; /**< sequence number of the latest record */
+    bool m_hasRecord; /**< whether there is a latest record */
+    unsigned int m_saveCount; /**< number of records saved */
+
+    /**
+     * Returns the EEPROM address of a slot.
+     */
+    unsigned int calculateSlotAddress(byte slot) const;
+
+    /**
+     * Checks the CRC of the record in a slot.
+     */
+    bool checkRecord(byte slot) const;
+
+    /**
+     * Checks whether a snapshot differs in a meaningful way from the
+     * one in the latest record.
+     */
+    bool hasMeaningfulChange(const LedSnapshot& snapshot,
+                             byte snapshotIndex) const;
+};
+
+#endif
@@ -0,0 +1,197 @@
+// Function definitions for the PinTrace class.
+
+// @author Janette H. Griggs
+// @version 1.0 10/19/26
+
+#include "PinTrace.h"
+
+PinTrace* PinTrace::s_activeTrace = NULL;
+
+PinTrace::PinTrace(PinTraceEvent events[], unsigned int eventCapacity) {
+  m_events = events;
+  m_eventCapacity = eventCapacity;
+  m_eventCount = 0;
+  m_traceTime = 0L;
+  m_isOverflowed = false;
+  m_tracedPins = 0L;
+  m_analogPins = 0L;
+}
+
+unsigned long PinTrace::getTraceTime() const {
+  return m_traceTime;
+}
+
+unsigned int PinTrace::getEventCount() const {
+  return m_eventCount;
+}
+
+const PinTraceEvent& PinTrace::getEvent(unsigned int index) const {
+  return m_events[index];
+}
+
+bool PinTrace::getIsOverflowed() const {
+  return m_isOverflowed;
+}
+
+void PinTrace::startTrace() {
+  m_eventCount = 0;
+  m_traceTime = 0L;
+  m_isOverflowed = false;
+  m_tracedPins = 0L;
+  m_analogPins = 0L;
+  s_activeTrace = this;
+}
+
+void PinTrace::stopTrace() {
+  if (s_activeTrace == this) {
+    s_activeTrace = NULL;
+  }
+}
+
+void PinTrace::advanceTime(unsigned long deltaMillis) {
+  m_traceTime += deltaMillis;
+}
+
+void PinTrace::writeVcd(Print& output) const {
+  unsigned long previousTime = 0L;
+
+  output.println("$timescale 1ms $end");
+  output.println("$scope module arduino $end");
+
+  for (byte pinNumber = 0; pinNumber < PIN_COUNT; pinNumber++) {
+    if ((m_tracedPins >> pinNumber) & 1) {
+      if ((m_analogPins >> pinNumber) & 1) {
+        output.print("$var wire 16 ");
+      } else {
+        output.print("$var wire 1 ");
+      }
+
+      writeVcdIdentifier(output, pinNumber);
+      output.print(" pin");
+      output.print((int) pinNumber);
+      output.println(" $end");
+    }
+  }
+
+  output.println("$upscope $end");
+  output.println("$enddefinitions $end");
+
+  for (unsigned int i = 0; i < m_eventCount; i++) {
+    const PinTraceEvent& event = m_events[i];
+
+    if (i == 0 || event.time != previousTime) {
+      output.print('#');
+      output.println(event.time);
+      previousTime = event.time;
+    }
+
+    // Vector values are written in binary without leading zeros.
+    if ((m_analogPins >> event.pinNumber) & 1) {
+      output.print('b');
+
+      for (int bit = 15; bit > 0; bit--) {
+        if ((event.value >> bit) != 0) {
+          output.print((char) ('0' + ((event.value >> bit) & 1)));
+        }
+      }
+
+      output.print((char) ('0' + (event.value & 1)));
+      output.print(' ');
+    } else {
+      output.print((char) ('0' + (event.value != 0)));
+    }
+
+    writeVcdIdentifier(output, event.pinNumber);
+    output.println();
+  }
+}
+
+void PinTrace::writeEvents(Print& output) const {
+  for (unsigned int i = 0; i < m_eventCount; i++) {
+    output.print("  {");
+    output.print(m_events[i].time);
+    output.print("L, ");
+    output.print((int) m_events[i].pinNumber);
+    output.print(", ");
+    output.print(m_events[i].value);
+    output.println("},");
+  }
+}
+
+int PinTrace::findMismatch(const PinTraceEvent goldenEvents[],
+                           unsigned int goldenEventCount,
+                           unsigned long timeTolerance) const {
+  int mismatch = NO_MISMATCH;
+  unsigned long timeDifference;
+
+  for (unsigned int i = 0; 
+       mismatch == NO_MISMATCH && 
+       (i < m_eventCount || i < goldenEventCount); 
+       i++) {
+    if (i >= m_eventCount || i >= goldenEventCount) {
+      mismatch = i;
+    } else {
+      if (m_events[i].time > goldenEvents[i].time) {
+        timeDifference = m_events[i].time - goldenEvents[i].time;
+      } else {
+        timeDifference = goldenEvents[i].time - m_events[i].time;
+      }
+
+      if (m_events[i].pinNumber != goldenEvents[i].pinNumber ||
+          m_events[i].value != goldenEvents[i].value ||
+          timeDifference > timeTolerance) {
+        mismatch = i;
+      }
+    }
+  }
+
+  return mismatch;
+}
+
+void PinTrace::recordAnalogWrite(int pinNumber, unsigned int value) {
+  if (s_activeTrace != NULL) {
+    s_activeTrace->recordWrite(pinNumber, value, true);
+  }
+}
+
+void PinTrace::recordDigitalWrite(int pinNumber, unsigned int value) {
+  if (s_activeTrace != NULL) {
+    s_activeTrace->recordWrite(pinNumber, value, false);
+  }
+}
+
+PinTrace::~PinTrace() {
+  stopTrace();
+}
+
+void PinTrace::recordWrite(int pinNumber, unsigned int value, 
+                           bool isAnalog) {
+  unsigned long pinBit;
+
+  if (pinNumber >= 0 && pinNumber < PIN_COUNT) {
+    pinBit = 1UL << pinNumber;
+
+    if (!(m_tracedPins & pinBit) || m_pinValues[pinNumber] != value) {
+      if (m_eventCount < m_eventCapacity) {
+        m_events[m_eventCount].time = m_traceTime;
+        m_events[m_eventCount].pinNumber = pinNumber;
+        m_events[m_eventCount].value = value;
+        m_eventCount++;
+
+        m_tracedPins |= pinBit;
+        m_pinValues[pinNumber] = value;
+
+        if (isAnalog) {
+          m_analogPins |= pinBit;
+        }
+      } else {
+        m_isOverflowed = true;
+      }
+    }
+  }
+}
+
+void PinTrace::writeVcdIdentifier(Print& output, byte pinNumber) const {
+  // VCD identifiers are printable characters, starting at '!'.
+  output.print((char) ('!' + pinNumber));
+}
@@ -0,0 +1,172 @@
+/**
+ * PinTrace class.
+ *
+ * This class records the pin writes of the LED libraries, with
+ * timestamps based on the same change in millis() between the loop()
+ * function calls that the libraries use, so a trace does not depend
+ * on how long the loop actually took. Only writes that change the
+ * value of a pin are recorded.
+ *
+ * A trace can be written out as a VCD file for waveform viewers, 
+ * written out as a PinTraceEvent array to use as a golden trace, and
+ * compared against a golden trace with a timing tolerance, to check
+ * that a change to the libraries keeps their behavior the same.
+ *
+ * Example:
+ *   PinTraceEvent events[100];
+ *   PinTrace trace(events, 100);
+ *   AnalogLed::setWriteObserver(PinTrace::recordAnalogWrite);
+ *   DigitalLed::setWriteObserver(PinTrace::recordDigitalWrite);
+ *   trace.startTrace();
+ *   // In loop(): trace.advanceTime(deltaMillis); 
+ *
+ * @author Janette H. Griggs
+ * @version 1.0 10/19/26
+ */
+
+#ifndef PinTrace_h
+  #define PinTrace_h
+
+#ifndef __AVR_ATmega328P__
+  #define __AVR_ATmega328P__
+#endif
+#ifndef Arduino_h
+  #include <Arduino.h>
+#endif
+#ifndef PinTraceEvent_h
+  #include "PinTraceEvent.h"
+#endif
+
+class PinTrace {
+  public:
+    static const int NO_MISMATCH = -1; /**< event index when traces 
+                                       match */
+    static const byte PIN_COUNT = 20; /**< number of Arduino Uno pins */
+
+    /**
+     * Constructor.
+     * @param events The array to record events in. The array must 
+     * exist for as long as the trace does.
+     * @param eventCapacity The number of events the array holds.
+     */
+    PinTrace(PinTraceEvent events[], unsigned int eventCapacity);
+
+    /**
+     * Returns the time (in ms) since the trace was started.
+     * @return The trace time.
+     */
+    unsigned long getTraceTime() const;
+
+    /**
+     * Returns the number of recorded events.
+     * @return The event count.
+     */
+    unsigned int getEventCount() const;
+
+    /**
+     * Returns a recorded event.
+     * @param index The event index, less than the event count.
+     * @return The event.
+     */
+    const PinTraceEvent& getEvent(unsigned int index) const;
+
+    /**
+     * Returns whether events were dropped because the event array
+     * was full.
+     * @return The overflow state.
+     */
+    bool getIsOverflowed() const;
+
+    /**
+     * Clears the trace and starts recording into it. Any other trace
+     * stops recording.
+     */
+    void startTrace();
+
+    /**
+     * Stops recording into the trace.
+     */
+    void stopTrace();
+
+    /**
+     * Advances the trace time.
+     * NOTE: Call this function during each loop with the same change
+     * in time that is passed to the LED libraries.
+     * @param deltaMillis The change in time (ms) from the previous loop.
+     */
+    void advanceTime(unsigned long deltaMillis);
+
+    /**
+     * Writes the trace as a VCD (value change dump) file, with a 
+     * timescale of 1 ms. Pins written by AnalogLed are 16-bit values 
+     * and pins written by DigitalLed are 1-bit values.
+     * @param output The output to write to, e.g. Serial.
+     */
+    void writeVcd(Print& output) const;
+
+    /**
+     * Writes the trace as the initializer of a PinTraceEvent array, 
+     * one event per line, to use as a golden trace.
+     * @param output The output to write to, e.g. Serial.
+     */
+    void writeEvents(Print& output) const;
+
+    /**
+     * Compares the trace against a golden trace. The events must have
+     * the same pin numbers and values in the same order, and their 
+     * times may differ by at most the time tolerance.
+     * @param goldenEvents The golden trace events.
+     * @param goldenEventCount The number of golden trace events.
+     * @param timeTolerance The allowed time difference (ms).
+     * @return The index of the first event that does not match, or 
+     * NO_MISMATCH if the traces match.
+     */
+    int findMismatch(const PinTraceEvent goldenEvents[],
+                     unsigned int goldenEventCount,
+                     unsigned long timeTolerance) const;
+
+    /**
+     * Records a write by AnalogLed into the active trace. Pass this 
+     * function to AnalogLed::setWriteObserver().
+     * @param pinNumber The pin number.
+     * @param value The PWM duty written.
+     */
+    static void recordAnalogWrite(int pinNumber, unsigned int value);
+
+    /**
+     * Records a write by DigitalLed into the active trace. Pass this
+     * function to DigitalLed::setWriteObserver().
+     * @param pinNumber The pin number.
+     * @param value The pin state written.
+     */
+    static void recordDigitalWrite(int pinNumber, unsigned int value);
+
+    /**
+     * Destructor.
+     */
+    ~PinTrace();
+  private:
+    static PinTrace* s_activeTrace; /**< trace that is recording */
+
+    PinTraceEvent* m_events; /**< recorded events */
+    unsigned int m_eventCapacity; /**< size of the event array */
+    unsigned int m_eventCount; /**< number of recorded events */
+    unsigned long m_traceTime; /**< time (ms) since the trace started */
+    bool m_isOverflowed; /**< overflow state of the event array */
+    unsigned long m_tracedPins; /**< bit set for each pin written */
+    unsigned long m_analogPins; /**< bit set for each pin written by
+                                AnalogLed */
+    unsigned int m_pinValues[PIN_COUNT]; /**< last value of each pin */
+
+    /**
+     * Records a write if it changes the value of the pin.
+     */
+    void recordWrite(int pinNumber, unsigned int value, bool isAnalog);
+
+    /**
+     * Writes the VCD identifier of a pin.
+     */
+    void writeVcdIdentifier(Print& output, byte pinNumber) const;
+};
+
+#endif
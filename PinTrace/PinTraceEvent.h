@@ -0,0 +1,24 @@
+// PinTraceEvent struct for a write to a pin, recorded
+// by PinTrace.
+
+// @author Janette H. Griggs
+// @version 1.0 10/19/26
+
+#ifndef PinTraceEvent_h
+  #define PinTraceEvent_h
+
+#ifndef __AVR_ATmega328P__
+  #define __AVR_ATmega328P__
+#endif
+#ifndef Arduino_h
+  #include <Arduino.h>
+#endif
+
+struct PinTraceEvent {
+  unsigned long time; /**< trace time (ms) of the write */
+  byte pinNumber; /**< pin number */
+  unsigned int value; /**< value written, i.e. the pin state or PWM 
+                      duty */
+};
+
+#endif
@@ -0,0 +1,144 @@
+// Function definitions for the AnalogButtonLadder class.
+
+// @author Janette H. Griggs
+// @version 1.1 10/19/26
+
+#include "AnalogButtonLadder.h"
+
+AnalogButtonLadder::AnalogButtonLadder(int analogPinNumber,
+                                       const int thresholds[],
+                                       byte buttonCount,
+                                       ResistorMode resistorMode) {
+  m_analogPinNumber = analogPinNumber;
+  m_thresholds = thresholds;
+  m_buttonCount = buttonCount;
+  m_resistorMode = resistorMode;
+
+  // Allow both A0 and 0 for the first analog pin, as analogRead() does.
+  if (m_analogPinNumber >= A0) {
+    m_analogChannel = m_analogPinNumber - A0;
+  } else {
+    m_analogChannel = m_analogPinNumber;
+  }
+
+  if (m_resistorMode == PULL_UP) {
+    m_analogReading = 1023;
+  } else if (m_resistorMode == PULL_DOWN) {
+    m_analogReading = 0;
+  }
+
+  m_buttonPushState = NO_BUTTON;
+  m_currentReading = m_buttonPushState;
+  m_previousReading = m_currentReading;
+  m_debounceTimer = 0L;
+
+  pinMode(m_analogChannel + A0, INPUT);
+}
+
+int AnalogButtonLadder::getAnalogPinNumber() const {
+  return m_analogPinNumber;
+}
+
+byte AnalogButtonLadder::getButtonCount() const {
+  return m_buttonCount;
+}
+
+int AnalogButtonLadder::getAnalogReading() const {
+  return m_analogReading;
+}
+
+int AnalogButtonLadder::getButtonPushState() const {
+  return m_buttonPushState;
+}
+
+int AnalogButtonLadder::getCurrentReading() const {
+  return m_currentReading;
+}
+
+int AnalogButtonLadder::getPreviousReading() const {
+  return m_previousReading;
+}
+
+unsigned long AnalogButtonLadder::getDebounceTimer() const {
+  return m_debounceTimer;
+}
+
+int AnalogButtonLadder::detectPush(unsigned long deltaMillis,
+                                   unsigned long debounceDelay) {
+  int pushedButton = NO_BUTTON;
+
+  updateAnalogReading();
+  m_currentReading = decodeButton();
+
+  // If the current reading is not equal to the button push
+  // state, debounce to verify that the button push state has 
+  // actually changed.
+  // If the button push state has actually changed to a button,
+  // that button is considered to be pushed.
+  if (m_currentReading != m_buttonPushState) {
+    if (m_currentReading != m_previousReading) {
+      m_debounceTimer = 0L;
+    } else if (m_debounceTimer >= debounceDelay) {
+      m_buttonPushState = m_currentReading;
+      pushedButton = m_buttonPushState;
+    } else {
+      m_debounceTimer += deltaMillis;
+    }
+  } else {
+    m_debounceTimer = 0L;
+  }
+
+  m_previousReading = m_currentReading;
+
+  return pushedButton;
+}
+
+void AnalogButtonLadder::finishConversion() {
+  while (ADCSRA & _BV(ADSC)) {
+    // Wait for the conversion to finish.
+  }
+
+  if ((ADMUX & 0x0F) == m_analogChannel) {
+    m_analogReading = ADC;
+  }
+}
+
+AnalogButtonLadder::~AnalogButtonLadder() {
+
+}
+
+void AnalogButtonLadder::updateAnalogReading() {
+  // ADSC stays set while a conversion is running. Only take the result
+  // if the last conversion was on the ladder channel, since analogRead()
+  // may have used the ADC for another pin in the meantime.
+  if (!(ADCSRA & _BV(ADSC))) {
+    if ((ADMUX & 0x0F) == m_analogChannel) {
+      m_analogReading = ADC;
+    }
+
+    // Keep the reference bits set by analogRead(). Forcing the AVcc
+    // reference would short AVcc to an external reference on AREF.
+    ADMUX = (ADMUX & (_BV(REFS1) | _BV(REFS0))) | m_analogChannel;
+    ADCSRA |= _BV(ADSC);
+  }
+}
+
+int AnalogButtonLadder::decodeButton() const {
+  int button = NO_BUTTON;
+
+  if (m_resistorMode == PULL_UP) {
+    for (int i = m_buttonCount - 1; i >= 0; i--) {
+      if (m_analogReading < m_thresholds[i]) {
+        button = i;
+      }
+    }
+  } else if (m_resistorMode == PULL_DOWN) {
+    for (int i = 0; i < m_buttonCount; i++) {
+      if (m_analogReading >= m_thresholds[i]) {
+        button = i;
+      }
+    }
+  }
+
+  return button;
+}
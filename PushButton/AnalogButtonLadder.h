@@ -0,0 +1,153 @@
+/*
+ * AnalogButtonLadder class.
+ *
+ * This class handles several push buttons wired as a resistor ladder
+ * on one analog input pin of the Arduino Uno. Each button pulls the
+ * pin to a different voltage, and the analog reading is decoded into
+ * a button number using threshold bands. The decoded button is 
+ * debounced the same way as PushButton::detectPush().
+ *
+ * Conversions are started and collected without waiting, so reading
+ * the ladder never blocks the loop for the ~100 us that analogRead()
+ * takes. Each conversion result is used on the call after it started.
+ * NOTE: Use one AnalogButtonLadder per sketch. A ladder conversion is
+ * left running between calls, so the ADC belongs to the ladder. A 
+ * call to analogRead() for another pin while it runs would return the
+ * ladder's reading, so call finishConversion() right before each 
+ * analogRead(). The ladder uses the voltage reference that 
+ * analogRead() last set, so call analogRead() once in setup(), after
+ * any analogReference() call, before the first detectPush().
+ *
+ * @author Janette H. Griggs
+ * @version 1.1 10/19/26
+ */
+
+#ifndef AnalogButtonLadder_h
+  #define AnalogButtonLadder_h
+
+#ifndef __AVR_ATmega328P__
+  #define __AVR_ATmega328P__
+#endif
+#ifndef Arduino_h
+  #include <Arduino.h>
+#endif
+
+#include "ResistorMode.h"
+
+class AnalogButtonLadder {
+  public:
+    static const int NO_BUTTON = -1; /**< button number when no button
+                                     is pushed */
+
+    /**
+     * Constructor.
+     * Configures the analog pin for the button ladder input.
+     * @param analogPinNumber The Arduino analog pin number (A0 to A5)
+     * for the button ladder input.
+     * @param thresholds The array of analog reading thresholds, in
+     * ascending order, one per button. For PULL_UP, button n is read 
+     * when the reading is below thresholds[n] (and not below the one
+     * before it), and no button is read above the last threshold. For
+     * PULL_DOWN, button n is read when the reading is at or above 
+     * thresholds[n] (and below the one after it), and no button is 
+     * read below the first threshold. The array must exist for as long
+     * as the ladder does.
+     * @param buttonCount The number of buttons in the ladder.
+     * @param resistorMode The resistor mode configuration used in the
+     * circuit. This is one of the enum values: PULL_UP, PULL_DOWN.
+     */
+    AnalogButtonLadder(int analogPinNumber, const int thresholds[],
+                       byte buttonCount, ResistorMode resistorMode);
+
+    /**
+     * Returns the analog pin number.
+     * @return The analog pin number.
+     */
+    int getAnalogPinNumber() const;
+
+    /**
+     * Returns the number of buttons in the ladder.
+     * @return The number of buttons.
+     */
+    byte getButtonCount() const;
+
+    /**
+     * Returns the last analog reading of the ladder.
+     * @return The analog reading, between 0 and 1023.
+     */
+    int getAnalogReading() const;
+
+    /**
+     * Returns the pushed button number, verified by debouncing.
+     * @return The pushed button number, or NO_BUTTON.
+     */
+    int getButtonPushState() const;
+
+    /**
+     * Returns the button number decoded from the current reading.
+     * @return The current button number, or NO_BUTTON.
+     */
+    int getCurrentReading() const;
+
+    /**
+     * Returns the button number decoded from the reading of the 
+     * previous loop.
+     * @return The previous button number, or NO_BUTTON.
+     */
+    int getPreviousReading() const;
+
+    /**
+     * Returns the debounce timer (in ms).
+     * @return The debounce timer.
+     */
+    unsigned long getDebounceTimer() const;
+
+    /**
+     * Detects if a button on the ladder is pushed. Input is debounced
+     * for a specified duration to verify the reading. If a button is 
+     * actually pushed, its number is returned only once during a 
+     * continuous press.
+     * @param deltaMillis The change in time (ms) from the previous loop.
+     * @param debounceDelay The delay time (ms) for debouncing input.
+     * @return The pushed button number, or NO_BUTTON if no push is 
+     * detected.
+     */
+    int detectPush(unsigned long deltaMillis, unsigned long debounceDelay);
+
+    /**
+     * Waits for the running ladder conversion, if any, and keeps its
+     * result, so the ADC is free for analogRead() on another pin. Takes
+     * at most about 110 us.
+     */
+    void finishConversion();
+
+    /**
+     * Destructor.
+     */
+    ~AnalogButtonLadder();
+  private:
+    int m_analogPinNumber; /**< analog pin number */
+    byte m_analogChannel; /**< ADC channel of the analog pin */
+    const int* m_thresholds; /**< analog reading threshold of each 
+                             button */
+    byte m_buttonCount; /**< number of buttons */
+    ResistorMode m_resistorMode; /**< resistor mode of the ladder */
+    int m_analogReading; /**< last analog reading */
+    int m_buttonPushState; /**< pushed button number */
+    int m_currentReading; /**< current button number */
+    int m_previousReading; /**< previous button number */
+    unsigned long m_debounceTimer; /**< debounce timer (ms) */
+
+    /**
+     * Collects the result of the last conversion, if it has finished,
+     * and starts the next one with the current voltage reference.
+     */
+    void updateAnalogReading();
+
+    /**
+     * Decodes the analog reading into a button number.
+     */
+    int decodeButton() const;
+};
+
+#endif
@@ -0,0 +1,27 @@
+// ButtonCombo struct for a combo recognized by ComboDetector.
+
+// @author Janette H. Griggs
+// @version 1.0 10/19/26
+
+#ifndef ButtonCombo_h
+  #define ButtonCombo_h
+
+#ifndef __AVR_ATmega328P__
+  #define __AVR_ATmega328P__
+#endif
+#ifndef Arduino_h
+  #include <Arduino.h>
+#endif
+
+enum ComboType {CHORD_COMBO, SEQUENCE_COMBO};
+
+struct ButtonCombo {
+  byte type; /**< ComboType of the combo */
+  unsigned long buttons; /**< chord: bit n set for button n, 
+                         sequence: button numbers + 1, one per byte 
+                         with the last button in the low byte */
+  unsigned long sequenceMask; /**< sequence: mask of the bytes used in
+                              buttons */
+};
+
+#endif
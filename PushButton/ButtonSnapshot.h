@@ -0,0 +1,25 @@
+// ButtonSnapshot struct for a consistent copy of the state of a 
+// PushButton.
+
+// @author Janette H. Griggs
+// @version 1.0 10/19/26
+
+#ifndef ButtonSnapshot_h
+  #define ButtonSnapshot_h
+
+#ifndef __AVR_ATmega328P__
+  #define __AVR_ATmega328P__
+#endif
+#ifndef Arduino_h
+  #include <Arduino.h>
+#endif
+
+struct ButtonSnapshot {
+  bool isPushed; /**< debounced push state is the active value */
+  bool isTransitioning; /**< reading differs from the push state */
+  unsigned long debounceTimer; /**< debounce timer (ms) */
+  unsigned long pushLatency; /**< push latency (ms) of last push */
+  unsigned int rejectedPushCount; /**< number of rejected pushes */
+};
+
+#endif
@@ -0,0 +1,162 @@
+// Function definitions for the ComboDetector class.
+
+// @author Janette H. Griggs
+// @version 1.1 10/19/26
+
+#include "ComboDetector.h"
+
+ComboDetector::ComboDetector(ButtonCombo combos[], byte comboCapacity,
+                             unsigned long comboWindow) {
+  m_combos = combos;
+  m_comboCapacity = comboCapacity;
+  m_comboCount = 0;
+  m_comboWindow = comboWindow;
+  m_pushTimer = 0L;
+  m_chordTimer = 0L;
+  m_previousState = 0L;
+  m_chordPushes = 0L;
+  m_pushHistory = 0L;
+}
+
+byte ComboDetector::getComboCount() const {
+  return m_comboCount;
+}
+
+unsigned long ComboDetector::getComboWindow() const {
+  return m_comboWindow;
+}
+
+void ComboDetector::setComboWindow(unsigned long comboWindow) {
+  m_comboWindow = comboWindow;
+}
+
+int ComboDetector::addChord(unsigned long buttons) {
+  int comboNumber = NO_COMBO;
+
+  if (m_comboCount < m_comboCapacity) {
+    comboNumber = m_comboCount;
+
+    m_combos[comboNumber].type = CHORD_COMBO;
+    m_combos[comboNumber].buttons = buttons;
+    m_combos[comboNumber].sequenceMask = 0L;
+
+    m_comboCount++;
+  }
+
+  return comboNumber;
+}
+
+int ComboDetector::addSequence(const byte buttons[],
+                               byte sequenceLength) {
+  int comboNumber = NO_COMBO;
+
+  if (m_comboCount < m_comboCapacity && sequenceLength > 0 &&
+      sequenceLength <= MAX_SEQUENCE_LENGTH) {
+    comboNumber = m_comboCount;
+
+    m_combos[comboNumber].type = SEQUENCE_COMBO;
+    m_combos[comboNumber].buttons = 0L;
+    m_combos[comboNumber].sequenceMask = 0L;
+
+    // Pack the sequence the same way as the push history, so it can be
+    // matched with one compare.
+    for (byte i = 0; i < sequenceLength; i++) {
+      m_combos[comboNumber].buttons = 
+          (m_combos[comboNumber].buttons << 8) | (buttons[i] + 1);
+      m_combos[comboNumber].sequenceMask = 
+          (m_combos[comboNumber].sequenceMask << 8) | 0xFF;
+    }
+
+    m_comboCount++;
+  }
+
+  return comboNumber;
+}
+
+int ComboDetector::detectCombo(unsigned long deltaMillis,
+                               unsigned long pushState) {
+  int comboNumber = NO_COMBO;
+  unsigned long pushes = pushState & ~m_previousState;
+
+  m_pushTimer += deltaMillis;
+  m_chordTimer += deltaMillis;
+
+  if (pushes != 0) {
+    // A push after the combo window starts a new combo. A sequence
+    // only needs each push within the window of the one before it, but
+    // a chord needs all of its pushes within the window of its first
+    // push, so slowly staggered pushes never add up to a chord.
+    if (m_pushTimer > m_comboWindow) {
+      m_pushHistory = 0L;
+    }
+
+    if (m_chordTimer > m_comboWindow) {
+      m_chordPushes = 0L;
+    }
+
+    if (m_chordPushes == 0) {
+      m_chordTimer = 0L;
+    }
+
+    m_pushTimer = 0L;
+    m_chordPushes |= pushes;
+
+    for (byte i = 0; pushes != 0; i++) {
+      if (pushes & 1) {
+        m_pushHistory = (m_pushHistory << 8) | (i + 1);
+      }
+
+      pushes >>= 1;
+    }
+
+    comboNumber = matchCombo(pushState);
+
+    // Start over, so the pushes of a combo don't complete another one.
+    if (comboNumber != NO_COMBO) {
+      m_chordPushes = 0L;
+      m_pushHistory = 0L;
+    }
+  }
+
+  m_previousState = pushState;
+
+  return comboNumber;
+}
+
+unsigned long ComboDetector::readPushState(PushButton* buttons[],
+                                           byte buttonCount) {
+  unsigned long pushState = 0L;
+
+  for (byte i = 0; i < buttonCount; i++) {
+    if (buttons[i]->getButtonPushState() == buttons[i]->getActiveValue()) {
+      pushState |= 1UL << i;
+    }
+  }
+
+  return pushState;
+}
+
+int ComboDetector::matchCombo(unsigned long pushState) const {
+  int comboNumber = NO_COMBO;
+
+  for (byte i = 0; i < m_comboCount && comboNumber == NO_COMBO; i++) {
+    const ButtonCombo& combo = m_combos[i];
+
+    // A chord matches when exactly its buttons are held and all of them
+    // were pushed within the window.
+    if (combo.type == CHORD_COMBO) {
+      if (pushState == combo.buttons &&
+          (m_chordPushes & combo.buttons) == combo.buttons) {
+        comboNumber = i;
+      }
+    } else if ((m_pushHistory & combo.sequenceMask) == combo.buttons) {
+      comboNumber = i;
+    }
+  }
+
+  return comboNumber;
+}
+
+ComboDetector::~ComboDetector() {
+
+}
@@ -0,0 +1,142 @@
+/*
+ * ComboDetector class.
+ *
+ * This class recognizes button combos from the debounced push state of
+ * up to 32 buttons, given as a bitmask with bit n set while button n
+ * is pushed, e.g. from readPushState() or
+ * KeypadMatrix::getKeyPushState(). Two kinds of combos are supported:
+ *
+ * - A chord is a set of buttons that are all pushed within the combo
+ *   window of the first of them and then held together.
+ * - A sequence is up to 4 buttons pushed one after the other, with no
+ *   more than the combo window between pushes.
+ *
+ * The last 4 pushes are kept in one unsigned long, one per byte, so 
+ * each combo is matched with a single mask and compare, whatever its
+ * length. A combo is reported once, when its last button is pushed.
+ *
+ * Combos are stored in an array supplied by the sketch, so nothing is
+ * allocated at run time.
+ *
+ * @author Janette H. Griggs
+ * @version 1.1 10/19/26
+ */
+
+#ifndef ComboDetector_h
+  #define ComboDetector_h
+
+#ifndef __AVR_ATmega328P__
+  #define __AVR_ATmega328P__
+#endif
+#ifndef Arduino_h
+  #include <Arduino.h>
+#endif
+#ifndef PushButton_h
+  #include "PushButton.h"
+#endif
+#ifndef ButtonCombo_h
+  #include "ButtonCombo.h"
+#endif
+
+class ComboDetector {
+  public:
+    static const int NO_COMBO = -1; /**< combo number when there is no 
+                                    combo */
+    static const byte MAX_SEQUENCE_LENGTH = 4; /**< longest sequence */
+
+    /**
+     * Constructor.
+     * @param combos The array to store the combos in. The array must
+     * exist for as long as the detector does.
+     * @param comboCapacity The number of combos the array holds.
+     * @param comboWindow The longest time (ms) from the first to the
+     * last push of a chord, and between the pushes of a sequence.
+     */
+    ComboDetector(ButtonCombo combos[], byte comboCapacity,
+                  unsigned long comboWindow);
+
+    /**
+     * Returns the number of combos.
+     * @return The combo count.
+     */
+    byte getComboCount() const;
+
+    /**
+     * Returns the combo window (in ms).
+     * @return The combo window.
+     */
+    unsigned long getComboWindow() const;
+
+    /**
+     * Sets the combo window (in ms).
+     * @param comboWindow The combo window.
+     */
+    void setComboWindow(unsigned long comboWindow);
+
+    /**
+     * Adds a chord. When combos share buttons, add the combo with the 
+     * most buttons first, since the first match is reported.
+     * @param buttons The buttons of the chord, with bit n set for 
+     * button n.
+     * @return The combo number, or NO_COMBO if the combo array is full.
+     */
+    int addChord(unsigned long buttons);
+
+    /**
+     * Adds a sequence. When combos share buttons, add the combo with 
+     * the most buttons first, since the first match is reported.
+     * @param buttons The button numbers (0 to 254), in the order they
+     * are pushed.
+     * @param sequenceLength The number of buttons, at most 
+     * MAX_SEQUENCE_LENGTH.
+     * @return The combo number, or NO_COMBO if the combo array is full
+     * or the sequence is too long.
+     */
+    int addSequence(const byte buttons[], byte sequenceLength);
+
+    /**
+     * Detects if a combo was completed.
+     * NOTE: Call this function during each loop, after debouncing the
+     * buttons.
+     * @param deltaMillis The change in time (ms) from the previous loop.
+     * @param pushState The debounced push state, with bit n set while
+     * button n is pushed.
+     * @return The combo number, or NO_COMBO.
+     */
+    int detectCombo(unsigned long deltaMillis, unsigned long pushState);
+
+    /**
+     * Returns the debounced push state of up to 32 push buttons as a
+     * bitmask.
+     * @param buttons The push buttons, where buttons[n] is button n.
+     * @param buttonCount The number of push buttons.
+     * @return The push state, with bit n set while button n is pushed.
+     */
+    static unsigned long readPushState(PushButton* buttons[],
+                                       byte buttonCount);
+
+    /**
+     * Destructor.
+     */
+    ~ComboDetector();
+  private:
+    ButtonCombo* m_combos; /**< combos, in the order they were added */
+    byte m_comboCapacity; /**< size of the combo array */
+    byte m_comboCount; /**< number of combos */
+    unsigned long m_comboWindow; /**< longest time (ms) between pushes */
+    unsigned long m_pushTimer; /**< time (ms) since the last push */
+    unsigned long m_chordTimer; /**< time (ms) since the first push of
+                                the chord */
+    unsigned long m_previousState; /**< push state in previous loop */
+    unsigned long m_chordPushes; /**< buttons pushed within the combo 
+                                 window of the first of them */
+    unsigned long m_pushHistory; /**< last 4 pushed button numbers + 1,
+                                 with the latest in the low byte */
+
+    /**
+     * Returns the number of the first combo that matches.
+     */
+    int matchCombo(unsigned long pushState) const;
+};
+
+#endif
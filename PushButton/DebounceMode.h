@@ -0,0 +1,19 @@
+// DebounceMode enum for how a push button reading is debounced.
+
+// @author Janette H. Griggs
+// @version 1.0 10/19/26
+
+#ifndef DebounceMode_h
+  #define DebounceMode_h
+
+#ifndef __AVR_ATmega328P__
+  #define __AVR_ATmega328P__
+#endif
+#ifndef Arduino_h
+  #include <Arduino.h>
+#endif
+
+enum DebounceMode {DELAY_DEBOUNCE, INTEGRATOR_DEBOUNCE,
+                   LEADING_EDGE_DEBOUNCE};
+
+#endif
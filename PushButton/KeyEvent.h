@@ -0,0 +1,22 @@
+// KeyEvent struct for a debounced key push or release,
+// read from a KeypadMatrix.
+
+// @author Janette H. Griggs
+// @version 1.0 10/19/26
+
+#ifndef KeyEvent_h
+  #define KeyEvent_h
+
+#ifndef __AVR_ATmega328P__
+  #define __AVR_ATmega328P__
+#endif
+#ifndef Arduino_h
+  #include <Arduino.h>
+#endif
+
+struct KeyEvent {
+  byte keyNumber; /**< key number */
+  bool isPushed; /**< key was pushed, else released */
+};
+
+#endif
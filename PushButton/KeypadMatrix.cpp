@@ -0,0 +1,269 @@
+// Function definitions for the KeypadMatrix class.
+
+// @author Janette H. Griggs
+// @version 1.2 10/19/26
+
+#include "KeypadMatrix.h"
+
+KeypadMatrix::KeypadMatrix(const byte rowPinNumbers[], byte rowCount,
+                           const byte columnPinNumbers[],
+                           byte columnCount) {
+  // Keep the key numbers within the bits of the key state, so a 
+  // keypad that is too large only loses its last rows.
+  if (rowCount == 0 || columnCount == 0) {
+    rowCount = 0;
+    columnCount = 0;
+  } else {
+    if (columnCount > MAX_KEY_COUNT) {
+      columnCount = MAX_KEY_COUNT;
+    }
+
+    if (rowCount > MAX_KEY_COUNT / columnCount) {
+      rowCount = MAX_KEY_COUNT / columnCount;
+    }
+  }
+
+  m_rowPinNumbers = rowPinNumbers;
+  m_rowCount = rowCount;
+  m_columnPinNumbers = columnPinNumbers;
+  m_columnCount = columnCount;
+  m_scanRow = 0;
+  m_scanReading = 0L;
+  m_scanTimer = 0L;
+  m_keyPushState = 0L;
+  m_currentReading = m_keyPushState;
+  m_previousReading = m_currentReading;
+  m_keyEventStart = 0;
+  m_keyEventCount = 0;
+  m_isGhosting = false;
+
+  for (byte plane = 0; plane < DEBOUNCE_PLANE_COUNT; plane++) {
+    m_debouncePlanes[plane] = 0L;
+  }
+
+  // Rows that are not being scanned are left floating, so pushing
+  // several keys in one column never shorts two driven rows.
+  for (byte row = 0; row < m_rowCount; row++) {
+    pinMode(m_rowPinNumbers[row], INPUT);
+  }
+
+  for (byte column = 0; column < m_columnCount; column++) {
+    pinMode(m_columnPinNumbers[column], INPUT_PULLUP);
+  }
+
+  if (m_rowCount > 0) {
+    selectRow(m_scanRow);
+  }
+}
+
+byte KeypadMatrix::getRowCount() const {
+  return m_rowCount;
+}
+
+byte KeypadMatrix::getColumnCount() const {
+  return m_columnCount;
+}
+
+unsigned long KeypadMatrix::getKeyPushState() const {
+  return m_keyPushState;
+}
+
+bool KeypadMatrix::getIsKeyPushed(byte keyNumber) const {
+  bool isKeyPushed = false;
+
+  if (keyNumber < MAX_KEY_COUNT) {
+    isKeyPushed = (m_keyPushState >> keyNumber) & 1;
+  }
+
+  return isKeyPushed;
+}
+
+bool KeypadMatrix::getIsGhosting() const {
+  return m_isGhosting;
+}
+
+byte KeypadMatrix::getDebounceScanCount(byte keyNumber) const {
+  byte debounceScanCount = 0;
+
+  if (keyNumber < MAX_KEY_COUNT) {
+    for (byte plane = 0; plane < DEBOUNCE_PLANE_COUNT; plane++) {
+      debounceScanCount |= ((m_debouncePlanes[plane] >> keyNumber) & 1) 
+                           << plane;
+    }
+  }
+
+  return debounceScanCount;
+}
+
+byte KeypadMatrix::getKeyEventCount() const {
+  return m_keyEventCount;
+}
+
+bool KeypadMatrix::detectKeyEvents(unsigned long deltaMillis,
+                                   unsigned long debounceDelay) {
+  byte keyNumber = m_scanRow * m_columnCount;
+
+  if (m_rowCount > 0) {
+    m_scanTimer += deltaMillis;
+
+    // The row was selected during the previous loop, so its lines 
+    // have had time to settle. A pushed key reads LOW.
+    for (byte column = 0; column < m_columnCount; column++) {
+      if (digitalRead(m_columnPinNumbers[column]) == LOW) {
+        m_scanReading |= 1UL << (keyNumber + column);
+      }
+    }
+
+    pinMode(m_rowPinNumbers[m_scanRow], INPUT);
+    m_scanRow++;
+
+    if (m_scanRow == m_rowCount) {
+      debounceScan(debounceDelay);
+      m_scanRow = 0;
+      m_scanReading = 0L;
+      m_scanTimer = 0L;
+    }
+
+    selectRow(m_scanRow);
+  }
+
+  return m_keyEventCount > 0;
+}
+
+bool KeypadMatrix::readKeyEvent(KeyEvent& keyEvent) {
+  bool isRead = false;
+
+  if (m_keyEventCount > 0) {
+    keyEvent = m_keyEvents[m_keyEventStart];
+    m_keyEventStart = (m_keyEventStart + 1) % KEY_EVENT_QUEUE_SIZE;
+    m_keyEventCount--;
+    isRead = true;
+  }
+
+  return isRead;
+}
+
+KeypadMatrix::~KeypadMatrix() {
+
+}
+
+void KeypadMatrix::selectRow(byte row) {
+  pinMode(m_rowPinNumbers[row], OUTPUT);
+  digitalWrite(m_rowPinNumbers[row], LOW);
+}
+
+void KeypadMatrix::debounceScan(unsigned long debounceDelay) {
+  byte keyCount = m_rowCount * m_columnCount;
+  unsigned long scanMillis = 1L;
+  byte debounceScans = MAX_DEBOUNCE_SCANS;
+  unsigned long stableKeys;
+  unsigned long acceptedKeys;
+  unsigned long countingKeys;
+  unsigned long carry;
+
+  // A change is accepted once the key has been stable for the first
+  // whole number of scans that lasts the debounce delay.
+  if (m_scanTimer > 0) {
+    scanMillis = m_scanTimer;
+  }
+
+  if (debounceDelay < MAX_DEBOUNCE_SCANS * scanMillis) {
+    debounceScans = (debounceDelay + scanMillis - 1) / scanMillis;
+  }
+
+  m_isGhosting = checkGhosting();
+
+  // A scan with possible ghosting can't be trusted, so restart the
+  // debounce counters and keep the readings of the last good scan.
+  // Otherwise, debounce each key the same way as 
+  // PushButton::detectPush(): a change of a key is accepted once its
+  // reading has been stable for the debounce delay.
+  if (m_isGhosting) {
+    for (byte plane = 0; plane < DEBOUNCE_PLANE_COUNT; plane++) {
+      m_debouncePlanes[plane] = 0L;
+    }
+  } else {
+    m_currentReading = m_scanReading;
+    stableKeys = (m_currentReading ^ m_keyPushState) & 
+                 ~(m_currentReading ^ m_previousReading);
+    acceptedKeys = stableKeys & findDebouncedKeys(debounceScans);
+    countingKeys = stableKeys & ~acceptedKeys;
+
+    // Count up the keys still waiting, adding one to all counters at 
+    // once with a ripple carry through the planes, and clear the 
+    // counters of the other keys. A full counter is always accepted,
+    // so it never wraps.
+    carry = countingKeys;
+
+    for (byte plane = 0; plane < DEBOUNCE_PLANE_COUNT; plane++) {
+      unsigned long planeBits = m_debouncePlanes[plane];
+
+      m_debouncePlanes[plane] = (planeBits ^ carry) & countingKeys;
+      carry &= planeBits;
+    }
+
+    m_keyPushState ^= acceptedKeys;
+
+    for (byte i = 0; i < keyCount; i++) {
+      if ((acceptedKeys >> i) & 1) {
+        queueKeyEvent(i, (m_keyPushState >> i) & 1);
+      }
+    }
+
+    m_previousReading = m_currentReading;
+  }
+}
+
+unsigned long KeypadMatrix::findDebouncedKeys(byte scanCount) const {
+  unsigned long greaterKeys = 0L;
+  unsigned long equalKeys = 0xFFFFFFFFUL;
+
+  // Compare all counters with the scan count at once, from the highest
+  // plane down.
+  for (byte plane = DEBOUNCE_PLANE_COUNT; plane > 0; plane--) {
+    unsigned long planeBits = m_debouncePlanes[plane - 1];
+
+    if ((scanCount >> (plane - 1)) & 1) {
+      equalKeys &= planeBits;
+    } else {
+      greaterKeys |= equalKeys & planeBits;
+      equalKeys &= ~planeBits;
+    }
+  }
+
+  return greaterKeys | equalKeys;
+}
+
+bool KeypadMatrix::checkGhosting() const {
+  unsigned long columnMask = 0xFFFFFFFFUL >> (32 - m_columnCount);
+  unsigned long sharedColumns;
+  bool isGhosting = false;
+
+  // Ghosting is possible when two rows have pushed keys in two or more
+  // of the same columns. Clearing the lowest set bit of the shared 
+  // columns leaves another one if two or more columns are shared.
+  for (byte row = 0; row < m_rowCount && !isGhosting; row++) {
+    for (byte otherRow = row + 1; otherRow < m_rowCount; otherRow++) {
+      sharedColumns = (m_scanReading >> (row * m_columnCount)) & 
+                      (m_scanReading >> (otherRow * m_columnCount)) & 
+                      columnMask;
+
+      if ((sharedColumns & (sharedColumns - 1)) != 0) {
+        isGhosting = true;
+      }
+    }
+  }
+
+  return isGhosting;
+}
+
+void KeypadMatrix::queueKeyEvent(byte keyNumber, bool isPushed) {
+  byte index;
+
+  if (m_keyEventCount < KEY_EVENT_QUEUE_SIZE) {
+    index = (m_keyEventStart + m_keyEventCount) % KEY_EVENT_QUEUE_SIZE;
+    m_keyEvents[index].keyNumber = keyNumber;
+    m_keyEvents[index].isPushed = isPushed;
+    m_keyEventCount++;
+  }
+}
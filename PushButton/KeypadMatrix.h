@@ -0,0 +1,194 @@
+/*
+ * KeypadMatrix class.
+ *
+ * This class handles a matrix keypad (e.g. 4x4) on the Arduino Uno.
+ * One row is scanned per loop, so a full scan never stalls the loop.
+ * Each key is debounced on its own the same way as 
+ * PushButton::detectPush(): a change of a key is accepted once its
+ * reading has been stable for the debounce delay, so a bouncing key
+ * never holds back the others. The push state of each key is kept as
+ * one bit, so up to 32 keys are supported, and any number of keys can
+ * be held at once (n-key rollover).
+ *
+ * The debounce state is a 4-bit vertical counter per key: each of the
+ * four counter bits of all keys is kept in one bit plane, so all keys
+ * are counted at once with a few bitwise operations per scan. The 
+ * counter counts the scans a key has been stable, and the debounce 
+ * delay is converted to scans with the time of the last scan, so it is
+ * at most 15 scans.
+ *
+ * Key pushes and releases are queued in the order they are accepted,
+ * to be read with readKeyEvent(). Changes accepted in the same scan
+ * are queued lowest key number first.
+ *
+ * Without diodes, pressing three corners of a rectangle also reads the
+ * fourth key (ghosting). Scans where this can happen are discarded.
+ *
+ * @author Janette H. Griggs
+ * @version 1.2 10/19/26
+ */
+
+#ifndef KeypadMatrix_h
+  #define KeypadMatrix_h
+
+#ifndef __AVR_ATmega328P__
+  #define __AVR_ATmega328P__
+#endif
+#ifndef Arduino_h
+  #include <Arduino.h>
+#endif
+
+#include "KeyEvent.h"
+
+class KeypadMatrix {
+  public:
+    static const byte MAX_KEY_COUNT = 32; /**< number of keys the
+                                          keypad holds */
+    static const byte KEY_EVENT_QUEUE_SIZE = 16; /**< number of key 
+                                                 events the queue 
+                                                 holds */
+    static const byte DEBOUNCE_PLANE_COUNT = 4; /**< number of bits of
+                                                each debounce counter */
+    static const byte MAX_DEBOUNCE_SCANS = 15; /**< most scans a debounce
+                                               delay can last */
+
+    /**
+     * Constructor.
+     * Configures the row pins for output and the column pins for input
+     * with the internal pull-up resistors. Key n is at row
+     * n / columnCount and column n % columnCount.
+     * @param rowPinNumbers The array of row pin numbers. The array must
+     * exist for as long as the keypad does.
+     * @param rowCount The number of rows.
+     * @param columnPinNumbers The array of column pin numbers. The array 
+     * must exist for as long as the keypad does.
+     * @param columnCount The number of columns. rowCount * columnCount 
+     * is at most 32. Rows beyond 32 keys are ignored, and a keypad
+     * without rows or columns has no keys and is never scanned.
+     */
+    KeypadMatrix(const byte rowPinNumbers[], byte rowCount,
+                 const byte columnPinNumbers[], byte columnCount);
+
+    /**
+     * Returns the number of rows.
+     * @return The number of rows.
+     */
+    byte getRowCount() const;
+
+    /**
+     * Returns the number of columns.
+     * @return The number of columns.
+     */
+    byte getColumnCount() const;
+
+    /**
+     * Returns the push state of all keys, verified by debouncing,
+     * with bit n set if key n is pushed.
+     * @return The key push state.
+     */
+    unsigned long getKeyPushState() const;
+
+    /**
+     * Returns whether a key is pushed, verified by debouncing.
+     * @param keyNumber The key number.
+     * @return The truth value of whether the key is pushed or not.
+     */
+    bool getIsKeyPushed(byte keyNumber) const;
+
+    /**
+     * Returns whether the last complete scan was discarded because of
+     * possible ghosting.
+     * @return The ghosting state.
+     */
+    bool getIsGhosting() const;
+
+    /**
+     * Returns the number of scans a key has been stable while its 
+     * change waits to be accepted.
+     * @param keyNumber The key number.
+     * @return The debounce scan count.
+     */
+    byte getDebounceScanCount(byte keyNumber) const;
+
+    /**
+     * Returns the number of queued key events.
+     * @return The key event count.
+     */
+    byte getKeyEventCount() const;
+
+    /**
+     * Scans the next row of the keypad. When a scan of all rows is
+     * complete, each key is debounced and any key pushes and releases
+     * are queued, to be read with readKeyEvent(). Events are dropped
+     * while the queue is full.
+     * NOTE: Call this function during each loop.
+     * @param deltaMillis The change in time (ms) from the previous loop.
+     * @param debounceDelay The delay time (ms) for debouncing input. 
+     * Delays longer than 15 scans are used as 15 scans.
+     * @return The truth value of whether any key events are queued.
+     */
+    bool detectKeyEvents(unsigned long deltaMillis,
+                         unsigned long debounceDelay);
+
+    /**
+     * Reads and removes the oldest key event from the queue.
+     * @param keyEvent The key event read.
+     * @return The truth value of whether a key event was read or not.
+     */
+    bool readKeyEvent(KeyEvent& keyEvent);
+
+    /**
+     * Destructor.
+     */
+    ~KeypadMatrix();
+  private:
+    const byte* m_rowPinNumbers; /**< row pin numbers */
+    byte m_rowCount; /**< number of rows */
+    const byte* m_columnPinNumbers; /**< column pin numbers */
+    byte m_columnCount; /**< number of columns */
+    byte m_scanRow; /**< row being scanned */
+    unsigned long m_scanReading; /**< key readings of the scan in 
+                                 progress */
+    unsigned long m_scanTimer; /**< time (ms) since the scan started */
+    unsigned long m_keyPushState; /**< key push state */
+    unsigned long m_currentReading; /**< key readings of the last scan */
+    unsigned long m_previousReading; /**< key readings of the scan 
+                                     before */
+    unsigned long m_debouncePlanes[DEBOUNCE_PLANE_COUNT]; /**< debounce
+                                                          counter bit
+                                                          planes, lowest
+                                                          bit first */
+    KeyEvent m_keyEvents[KEY_EVENT_QUEUE_SIZE]; /**< key events not yet
+                                                read, in a ring */
+    byte m_keyEventStart; /**< index of the oldest key event */
+    byte m_keyEventCount; /**< number of key events not yet read */
+    bool m_isGhosting; /**< ghosting state of the last scan */
+
+    /**
+     * Drives the row low so the keys in it can be read.
+     */
+    void selectRow(byte row);
+
+    /**
+     * Debounces the readings of each key after a complete scan.
+     */
+    void debounceScan(unsigned long debounceDelay);
+
+    /**
+     * Returns the keys whose debounce counters are at least a number 
+     * of scans.
+     */
+    unsigned long findDebouncedKeys(byte scanCount) const;
+
+    /**
+     * Checks the readings of a complete scan for possible ghosting.
+     */
+    bool checkGhosting() const;
+
+    /**
+     * Adds a key event to the end of the queue, unless it is full.
+     */
+    void queueKeyEvent(byte keyNumber, bool isPushed);
+};
+
+#endif
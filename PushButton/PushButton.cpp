@@ -1,9 +1,12 @@
 // Function definitions for the PushButton class. 
 
 // @author Janette H. Griggs
-// @version 1.2 03/31/14
+// @version 1.7 10/19/26
 
 #include "PushButton.h"
+#include <util/atomic.h>
+
+PushButton::ReadFunction PushButton::s_readFunction = NULL;
 
 PushButton::PushButton(int buttonPinNumber, ResistorMode resistorMode) {
   m_buttonPinNumber = buttonPinNumber;
@@ -14,10 +17,11 @@ PushButton::PushButton(int buttonPinNumber, ResistorMode resistorMode) {
     m_activeValue = HIGH;    
   }
 
-  m_buttonPushState = !(m_activeValue);
-  m_currentReading = m_buttonPushState;
-  m_previousReading = m_currentReading;
-  m_debounceTimer = 0L;
+  m_debounceDelay = 0L;
+  m_isAdaptiveDebounce = false;
+  m_debounceMode = DELAY_DEBOUNCE;
+  resetButton();
+  resetBounceStatistics();
 
   pinMode(m_buttonPinNumber, INPUT);
 }
@@ -46,11 +50,142 @@ unsigned long PushButton::getDebounceTimer() const {
   return m_debounceTimer;
 }
 
+unsigned long PushButton::getPushLatency() const {
+  return m_pushLatency;
+}
+
+unsigned int PushButton::getRejectedPushCount() const {
+  return m_rejectedPushCount;
+}
+
+unsigned long PushButton::getDebounceDelay() const {
+  return m_debounceDelay;
+}
+
+byte PushButton::getMaxBounceTime() const {
+  return m_maxBounceTime;
+}
+
+byte PushButton::getMeanBounceTime() const {
+  return (m_meanBounceTime + 128) >> 8;
+}
+
+unsigned int PushButton::getBounceSampleCount() const {
+  return m_bounceSampleCount;
+}
+
+bool PushButton::getIsAdaptiveDebounceState() const {
+  return m_isAdaptiveDebounce;
+}
+
+void PushButton::setAdaptiveDebounce(bool isAdaptiveDebounce) {
+  m_isAdaptiveDebounce = isAdaptiveDebounce;
+}
+
+DebounceMode PushButton::getDebounceMode() const {
+  return m_debounceMode;
+}
+
+void PushButton::setDebounceMode(DebounceMode debounceMode) {
+  m_debounceMode = debounceMode;
+  m_debounceTimer = 0L;
+  m_isTransitioning = false;
+  m_isLockedOut = false;
+}
+
+void PushButton::resetBounceStatistics() {
+  m_maxBounceTime = 0;
+  m_meanBounceTime = 0;
+  m_bounceSampleCount = 0;
+}
+
+PushButton::ReadFunction PushButton::getReadFunction() {
+  return s_readFunction;
+}
+
+void PushButton::setReadFunction(ReadFunction readFunction) {
+  s_readFunction = readFunction;
+}
+
+void PushButton::resetButton() {
+  m_buttonPushState = !(m_activeValue);
+  m_currentReading = m_buttonPushState;
+  m_previousReading = m_currentReading;
+  m_debounceTimer = 0L;
+  m_transitionTimer = 0L;
+  m_isTransitioning = false;
+  m_pushLatency = 0L;
+  m_rejectedPushCount = 0;
+  m_bounceTimer = 0L;
+  m_isLockedOut = false;
+}
+
+void PushButton::saveSnapshot(ButtonSnapshot& snapshot) const {
+  int buttonPushState;
+
+  // Copy the state with interrupts off, so an update from an interrupt
+  // can't change it partway through.
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    buttonPushState = m_buttonPushState;
+    snapshot.isTransitioning = m_isTransitioning;
+    snapshot.debounceTimer = m_debounceTimer;
+    snapshot.pushLatency = m_pushLatency;
+    snapshot.rejectedPushCount = m_rejectedPushCount;
+  }
+
+  snapshot.isPushed = buttonPushState == m_activeValue;
+}
+
 bool PushButton::detectPush(unsigned long deltaMillis, 
                             unsigned long debounceDelay) {
   bool isPushed = false;
 
-  m_currentReading = digitalRead(m_buttonPinNumber);
+  m_currentReading = readButtonPin();
+
+  // The learned delay only ever shortens the given delay.
+  if (m_isAdaptiveDebounce &&
+      m_bounceSampleCount >= ADAPTIVE_SAMPLE_COUNT &&
+      (unsigned long) m_maxBounceTime + ADAPTIVE_DEBOUNCE_MARGIN <
+      debounceDelay) {
+    m_debounceDelay = m_maxBounceTime + ADAPTIVE_DEBOUNCE_MARGIN;
+  } else {
+    m_debounceDelay = debounceDelay;
+  }
+
+  // The transition timer runs from the first reading that differs
+  // from the button push state, including any bouncing, until the
+  // push state changes or the reading settles back.
+  if (m_isTransitioning) {
+    m_transitionTimer += deltaMillis;
+  }
+
+  if (m_debounceMode == INTEGRATOR_DEBOUNCE) {
+    isPushed = integrateReading(deltaMillis);
+  } else if (m_debounceMode == LEADING_EDGE_DEBOUNCE) {
+    isPushed = detectLeadingEdge();
+  } else {
+    isPushed = debounceReading(deltaMillis);
+  }
+
+  m_previousReading = m_currentReading;
+
+  return isPushed;
+}
+
+int PushButton::readButtonPin() const {
+  int reading;
+
+  if (s_readFunction != NULL) {
+    reading = s_readFunction(m_buttonPinNumber);
+  } else {
+    reading = digitalRead(m_buttonPinNumber);
+  }
+
+  return reading;
+}
+
+bool PushButton::debounceReading(unsigned long deltaMillis) {
+  bool isPushed = false;
 
   // If the current reading is not equal to the button push
   // state, debounce to verify that the button push state has 
@@ -59,13 +194,39 @@ bool PushButton::detectPush(unsigned long deltaMillis,
   // to the active "ON" value, the button is considered to be
   // pushed.
   if (m_currentReading != m_buttonPushState) {
+    if (!m_isTransitioning) {
+      m_isTransitioning = true;
+      m_transitionTimer = 0L;
+    }
+
     if (m_currentReading != m_previousReading) {
       m_debounceTimer = 0L;
-    } else if (m_debounceTimer >= debounceDelay) {
+      m_bounceTimer = m_transitionTimer;
+    } else if (m_debounceTimer >= m_debounceDelay) {
       m_buttonPushState = m_currentReading;
+      m_isTransitioning = false;
+      measureBounce();
 
       if (m_buttonPushState == m_activeValue) {
         isPushed = true;
+        m_pushLatency = m_transitionTimer;
+      }
+    } else {
+      m_debounceTimer += deltaMillis;
+    }
+  } else if (m_isTransitioning) {
+    // The reading is back at the push state. Debounce it the same way
+    // to tell bouncing apart from a push that was too short, which is
+    // counted as rejected.
+    if (m_currentReading != m_previousReading) {
+      m_debounceTimer = 0L;
+      m_bounceTimer = m_transitionTimer;
+    } else if (m_debounceTimer >= m_debounceDelay) {
+      m_debounceTimer = 0L;
+      m_isTransitioning = false;
+
+      if (m_buttonPushState != m_activeValue) {
+        m_rejectedPushCount++;
       }
     } else {
       m_debounceTimer += deltaMillis;
@@ -74,11 +235,109 @@ bool PushButton::detectPush(unsigned long deltaMillis,
     m_debounceTimer = 0L;
   }
 
-  m_previousReading = m_currentReading;
+  return isPushed;
+}
+
+bool PushButton::integrateReading(unsigned long deltaMillis) {
+  bool isPushed = false;
+
+  // The debounce timer is used as the integrator. It counts up while
+  // the reading differs from the push state and back down while it
+  // doesn't, so bouncing only slows it down instead of restarting it.
+  if (m_currentReading != m_buttonPushState) {
+    if (!m_isTransitioning) {
+      m_isTransitioning = true;
+      m_transitionTimer = 0L;
+    }
+
+    m_debounceTimer += deltaMillis;
+
+    if (m_debounceTimer >= m_debounceDelay) {
+      m_buttonPushState = m_currentReading;
+      m_isTransitioning = false;
+      m_debounceTimer = 0L;
+
+      if (m_buttonPushState == m_activeValue) {
+        isPushed = true;
+        m_pushLatency = m_transitionTimer;
+      }
+    }
+  } else if (m_isTransitioning) {
+    if (m_debounceTimer > deltaMillis) {
+      m_debounceTimer -= deltaMillis;
+    } else {
+      m_debounceTimer = 0L;
+      m_isTransitioning = false;
+
+      if (m_buttonPushState != m_activeValue) {
+        m_rejectedPushCount++;
+      }
+    }
+  }
 
   return isPushed;
 }
 
+bool PushButton::detectLeadingEdge() {
+  bool isPushed = false;
+
+  // After a change, the push state is locked for the debounce delay,
+  // so the bouncing that follows the first edge is ignored. A reading
+  // must differ twice in a row to count as an edge, which filters out
+  // single glitches.
+  if (m_isLockedOut) {
+    if (m_transitionTimer >= m_debounceDelay) {
+      m_isLockedOut = false;
+      m_isTransitioning = false;
+    }
+  } else if (m_currentReading != m_buttonPushState) {
+    if (!m_isTransitioning) {
+      m_isTransitioning = true;
+      m_transitionTimer = 0L;
+    } else if (m_currentReading == m_previousReading) {
+      m_buttonPushState = m_currentReading;
+      m_isLockedOut = true;
+
+      if (m_buttonPushState == m_activeValue) {
+        isPushed = true;
+        m_pushLatency = m_transitionTimer;
+      }
+    }
+  } else if (m_isTransitioning) {
+    m_isTransitioning = false;
+
+    if (m_buttonPushState != m_activeValue) {
+      m_rejectedPushCount++;
+    }
+  }
+
+  return isPushed;
+}
+
+void PushButton::measureBounce() {
+  byte bounceTime = 255;
+
+  if (m_bounceTimer < 255) {
+    bounceTime = m_bounceTimer;
+  }
+
+  if (bounceTime > m_maxBounceTime) {
+    m_maxBounceTime = bounceTime;
+  }
+
+  // Exponential moving average with a weight of 1/8 for the new bounce.
+  if (m_bounceSampleCount == 0) {
+    m_meanBounceTime = bounceTime << 8;
+  } else {
+    m_meanBounceTime = m_meanBounceTime - (m_meanBounceTime >> 3) +
+                       ((unsigned int) bounceTime << 5);
+  }
+
+  if (m_bounceSampleCount < 0xFFFF) {
+    m_bounceSampleCount++;
+  }
+}
+
 PushButton::~PushButton() {
 
 }
\ No newline at end of file
@@ -10,7 +10,7 @@
  * repository for an example of this class implementation.
  *
  * @author Janette H. Griggs
- * @version 1.2 03/31/14
+ * @version 1.8 10/19/26
  */
 
 #ifndef PushButton_h
@@ -24,9 +24,25 @@
 #endif
 
 #include "ResistorMode.h"
+#include "DebounceMode.h"
+#include "ButtonSnapshot.h"
 
 class PushButton {
   public:
+    static const byte ADAPTIVE_SAMPLE_COUNT = 8; /**< number of bounces
+                                                 measured before the 
+                                                 debounce delay is 
+                                                 adapted */
+    static const byte ADAPTIVE_DEBOUNCE_MARGIN = 2; /**< time (ms) added
+                                                    to the longest 
+                                                    bounce */
+
+    /**
+     * Function called to read the state of a push button pin, in place
+     * of digitalRead().
+     */
+    typedef int (*ReadFunction)(int pinNumber);
+
     /**
      * Constructor.
      * Configures the push button for input.
@@ -76,6 +92,132 @@ class PushButton {
      */
     unsigned long getDebounceTimer() const;
 
+    /**
+     * Returns the push latency (in ms) of the last detected push, 
+     * which is the time from the first reading of the active value,
+     * including any bouncing, until the push is detected.
+     * @return The push latency.
+     */
+    unsigned long getPushLatency() const;
+
+    /**
+     * Returns the number of pushes that were read but not detected 
+     * because the reading went back to the inactive value before the
+     * debounce delay was over. With INTEGRATOR_DEBOUNCE or 
+     * LEADING_EDGE_DEBOUNCE, each filtered out glitch is counted, 
+     * including bouncing before a push.
+     * @return The rejected push count.
+     */
+    unsigned int getRejectedPushCount() const;
+
+    /**
+     * Returns the debounce delay (in ms) used by the last call to 
+     * detectPush(), which is shorter than the given delay once adaptive
+     * debounce has learned the bounce time.
+     * @return The debounce delay.
+     */
+    unsigned long getDebounceDelay() const;
+
+    /**
+     * Returns the longest bounce time (in ms) measured, which is the 
+     * time from the first to the last change of the reading in an 
+     * accepted push or release. Bounces longer than 255 ms are 
+     * counted as 255 ms.
+     * @return The maximum bounce time.
+     */
+    byte getMaxBounceTime() const;
+
+    /**
+     * Returns the running average of the bounce time (in ms), where 
+     * each new bounce counts for 1/8.
+     * @return The mean bounce time.
+     */
+    byte getMeanBounceTime() const;
+
+    /**
+     * Returns the number of bounces measured.
+     * @return The bounce sample count.
+     */
+    unsigned int getBounceSampleCount() const;
+
+    /**
+     * Returns whether adaptive debounce is on.
+     * @return The adaptive debounce state.
+     */
+    bool getIsAdaptiveDebounceState() const;
+
+    /**
+     * Turns adaptive debounce on or off. Bounce times are always 
+     * measured, but with adaptive debounce on, the debounce delay is
+     * lowered to the longest bounce plus ADAPTIVE_DEBOUNCE_MARGIN once
+     * ADAPTIVE_SAMPLE_COUNT bounces have been measured. The delay given
+     * to detectPush() is kept as the upper limit. A longer bounce 
+     * raises the delay again.
+     * @param isAdaptiveDebounce The adaptive debounce state.
+     */
+    void setAdaptiveDebounce(bool isAdaptiveDebounce);
+
+    /**
+     * Returns the debounce mode.
+     * @return The debounce mode.
+     */
+    DebounceMode getDebounceMode() const;
+
+    /**
+     * Sets how the reading is debounced. This is one of the enum
+     * values:
+     * DELAY_DEBOUNCE: A change is accepted once the reading has not 
+     * changed for the debounce delay (the default).
+     * INTEGRATOR_DEBOUNCE: A change is accepted once the reading has
+     * differed from the push state for the debounce delay more than it
+     * hasn't, so bouncing doesn't restart the delay.
+     * LEADING_EDGE_DEBOUNCE: A change is accepted on the first two
+     * readings in a row that differ from the push state, and no other
+     * change is accepted for the debounce delay. This detects a push 
+     * within one loop, but the delay must be longer than any bounce.
+     * Bounce times are only measured, and adaptive debounce only works,
+     * with DELAY_DEBOUNCE.
+     * @param debounceMode The debounce mode.
+     */
+    void setDebounceMode(DebounceMode debounceMode);
+
+    /**
+     * Clears the measured bounce times, e.g. after changing the switch.
+     */
+    void resetBounceStatistics();
+
+    /**
+     * Returns the function that reads the pins of all push buttons.
+     * @return The read function, or NULL for digitalRead().
+     */
+    static ReadFunction getReadFunction();
+
+    /**
+     * Sets a function to read the pins of all push buttons instead of
+     * digitalRead(), e.g. BounceReplay::readTrace() to replay a 
+     * recorded bounce trace without a switch or on a host computer.
+     * @param readFunction The read function, or NULL for digitalRead().
+     */
+    static void setReadFunction(ReadFunction readFunction);
+
+    /**
+     * Sets the push button back to the released state it has after 
+     * construction. Any push in progress is dropped, and the push 
+     * latency and rejected push count are set to 0. The debounce mode,
+     * adaptive debounce state and bounce statistics are kept.
+     */
+    void resetButton();
+
+    /**
+     * Saves the push state, timers and statistics of the push button.
+     * The state is copied with interrupts off, so the snapshot is 
+     * consistent even if the button is debounced from an interrupt.
+     * Interrupts are off while 13 bytes are copied, an estimated 50 
+     * cycles (not measured).
+     * @param snapshot The snapshot to save into.
+     */
+    void saveSnapshot(ButtonSnapshot& snapshot) const;
+
     /**
      * Detects if the push button is pushed. Input is debounced for a
      * specified duration to verify reading. If the button is actually  
@@ -92,12 +234,56 @@ class PushButton {
      */
     ~PushButton();
   private:
+    static ReadFunction s_readFunction; /**< reads push button pins */
+
     int m_buttonPinNumber; /**< push button pin number */
     int m_activeValue; /**< push button pin state value when pressed */
     int m_buttonPushState; /**< push button push state */    
     int m_currentReading; /**< push button current reading */
     int m_previousReading; /**< push button previous reading */
     unsigned long m_debounceTimer; /**< debounce timer (ms) */
+    unsigned long m_transitionTimer; /**< time (ms) since the reading first
+                                     differed from the push state */
+    bool m_isTransitioning; /**< transition state of push button reading */
+    unsigned long m_pushLatency; /**< push latency (ms) of last push */
+    unsigned int m_rejectedPushCount; /**< number of rejected pushes */
+    unsigned long m_debounceDelay; /**< debounce delay (ms) in use */
+    unsigned long m_bounceTimer; /**< time (ms) from the first to the
+                                 last change of the reading */
+    byte m_maxBounceTime; /**< longest bounce time (ms) */
+    unsigned int m_meanBounceTime; /**< mean bounce time (ms), in 8.8 
+                                   fixed point */
+    unsigned int m_bounceSampleCount; /**< number of bounces measured */
+    bool m_isAdaptiveDebounce; /**< adaptive debounce state */
+    DebounceMode m_debounceMode; /**< debounce mode */
+    bool m_isLockedOut; /**< leading edge lock out state */
+
+    /**
+     * Reads the push button pin with the read function, if any, and 
+     * else with digitalRead().
+     */
+    int readButtonPin() const;
+
+    /**
+     * Debounces the reading in the DELAY_DEBOUNCE mode.
+     */
+    bool debounceReading(unsigned long deltaMillis);
+
+    /**
+     * Debounces the reading in the INTEGRATOR_DEBOUNCE mode.
+     */
+    bool integrateReading(unsigned long deltaMillis);
+
+    /**
+     * Debounces the reading in the LEADING_EDGE_DEBOUNCE mode.
+     */
+    bool detectLeadingEdge();
+
+    /**
+     * Adds the bounce time of an accepted push or release to the 
+     * statistics.
+     */
+    void measureBounce();
 };
 
 #endif
\ No newline at end of file
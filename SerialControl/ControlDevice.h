@@ -0,0 +1,30 @@
+// ControlDevice struct and enums for SerialControl.
+
+// @author Janette H. Griggs
+// @version 1.0 10/19/26
+
+#ifndef ControlDevice_h
+  #define ControlDevice_h
+
+#ifndef __AVR_ATmega328P__
+  #define __AVR_ATmega328P__
+#endif
+#ifndef Arduino_h
+  #include <Arduino.h>
+#endif
+
+enum ControlDeviceType {ANALOG_LED_DEVICE, RGB_LED_DEVICE,
+                        DIGITAL_LED_DEVICE, PUSH_BUTTON_DEVICE};
+
+enum ControlMode {CONTROL_OFF, CONTROL_STEADY, CONTROL_BLINK,
+                  CONTROL_FADE_IN, CONTROL_FADE_OUT, CONTROL_FADE_IN_OUT};
+
+struct ControlDevice {
+  byte type; /**< ControlDeviceType of the device */
+  void* device; /**< the LED or push button */
+  byte mode; /**< ControlMode of an LED */
+  unsigned long interval; /**< blink or fade interval (ms) of an LED, or
+                          debounce delay (ms) of a push button */
+};
+
+#endif
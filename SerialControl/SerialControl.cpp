@@ -0,0 +1,294 @@
+// Function definitions for the SerialControl class.
+
+// @author Janette H. Griggs
+// @version 1.0 10/19/26
+
+#include "SerialControl.h"
+#include <util/crc16.h>
+
+SerialControl::SerialControl(Stream& stream, ControlDevice devices[],
+                             byte deviceCapacity)
+  : m_stream(stream) {
+  m_devices = devices;
+  m_deviceCapacity = deviceCapacity;
+  m_deviceCount = 0;
+  m_frameLength = 0;
+  m_isDiscardingFrame = false;
+  m_commandCount = 0L;
+  m_frameErrorCount = 0;
+}
+
+byte SerialControl::getDeviceCount() const {
+  return m_deviceCount;
+}
+
+ControlMode SerialControl::getDeviceMode(byte deviceNumber) const {
+  return (ControlMode) m_devices[deviceNumber].mode;
+}
+
+unsigned long SerialControl::getCommandCount() const {
+  return m_commandCount;
+}
+
+unsigned int SerialControl::getFrameErrorCount() const {
+  return m_frameErrorCount;
+}
+
+int SerialControl::addAnalogLed(AnalogLed& led) {
+  return addDevice(ANALOG_LED_DEVICE, &led, 0L);
+}
+
+int SerialControl::addRGBLed(AnalogRGBLed& led) {
+  return addDevice(RGB_LED_DEVICE, &led, 0L);
+}
+
+int SerialControl::addDigitalLed(DigitalLed& led) {
+  return addDevice(DIGITAL_LED_DEVICE, &led, 0L);
+}
+
+int SerialControl::addPushButton(PushButton& button,
+                                 unsigned long debounceDelay) {
+  return addDevice(PUSH_BUTTON_DEVICE, &button, debounceDelay);
+}
+
+void SerialControl::readCommands() {
+  int available = m_stream.available();
+  byte nextByte;
+  byte packetLength;
+
+  // Only the bytes already received are read, so this never waits.
+  for (int i = 0; i < available; i++) {
+    nextByte = m_stream.read();
+
+    if (nextByte == 0) {
+      if (m_isDiscardingFrame) {
+        m_frameErrorCount++;
+      } else if (m_frameLength > 0) {
+        packetLength = decodeFrame();
+
+        if (packetLength > 0 && runCommand(packetLength)) {
+          m_commandCount++;
+        } else {
+          m_frameErrorCount++;
+        }
+      }
+
+      m_frameLength = 0;
+      m_isDiscardingFrame = false;
+    } else if (m_frameLength < MAX_FRAME_SIZE) {
+      m_frame[m_frameLength] = nextByte;
+      m_frameLength++;
+    } else {
+      m_isDiscardingFrame = true;
+    }
+  }
+}
+
+void SerialControl::updateDevices(unsigned long deltaMillis) {
+  byte packet[4];
+
+  for (byte i = 0; i < m_deviceCount; i++) {
+    if (m_devices[i].type == PUSH_BUTTON_DEVICE) {
+      if (((PushButton*) m_devices[i].device)->detectPush(deltaMillis,
+          m_devices[i].interval)) {
+        packet[0] = EVENT_BUTTON_PUSH;
+        packet[1] = i;
+        writeFrame(packet, 2);
+      }
+    } else if (m_devices[i].mode != CONTROL_OFF) {
+      showLed(m_devices[i], deltaMillis);
+    }
+  }
+}
+
+int SerialControl::addDevice(ControlDeviceType type, void* device,
+                             unsigned long interval) {
+  int deviceNumber = NO_DEVICE;
+
+  if (m_deviceCount < m_deviceCapacity) {
+    deviceNumber = m_deviceCount;
+
+    m_devices[deviceNumber].type = type;
+    m_devices[deviceNumber].device = device;
+    m_devices[deviceNumber].mode = CONTROL_OFF;
+    m_devices[deviceNumber].interval = interval;
+
+    m_deviceCount++;
+  }
+
+  return deviceNumber;
+}
+
+byte SerialControl::decodeFrame() {
+  byte readIndex = 0;
+  byte writeIndex = 0;
+  byte code;
+  bool isValid = true;
+  unsigned int crc = 0xFFFF;
+
+  // The decoded packet is never longer than the frame, so it can be
+  // written over the frame as it is read.
+  while (isValid && readIndex < m_frameLength) {
+    code = m_frame[readIndex];
+
+    if (readIndex + code > m_frameLength) {
+      isValid = false;
+    } else {
+      readIndex++;
+
+      for (byte i = 1; i < code; i++) {
+        m_frame[writeIndex] = m_frame[readIndex];
+        writeIndex++;
+        readIndex++;
+      }
+
+      if (code < 0xFF && readIndex < m_frameLength) {
+        m_frame[writeIndex] = 0;
+        writeIndex++;
+      }
+    }
+  }
+
+  // A packet needs at least a command, a device number and the CRC.
+  if (!isValid || writeIndex < 4) {
+    writeIndex = 0;
+  } else {
+    writeIndex -= 2;
+
+    for (byte i = 0; i < writeIndex; i++) {
+      crc = _crc16_update(crc, m_frame[i]);
+    }
+
+    if (m_frame[writeIndex] != lowByte(crc) ||
+        m_frame[writeIndex + 1] != highByte(crc)) {
+      writeIndex = 0;
+    }
+  }
+
+  return writeIndex;
+}
+
+bool SerialControl::runCommand(byte packetLength) {
+  bool isValid = false;
+  byte command = m_frame[0];
+  byte deviceNumber = m_frame[1];
+
+  if (deviceNumber < m_deviceCount) {
+    ControlDevice& device = m_devices[deviceNumber];
+
+    if (command == COMMAND_SET_MODE && packetLength == 7 &&
+        device.type != PUSH_BUTTON_DEVICE &&
+        m_frame[2] <= CONTROL_FADE_IN_OUT) {
+      setDeviceMode(device, m_frame[2],
+                    (unsigned long) m_frame[3] |
+                    (unsigned long) m_frame[4] << 8 |
+                    (unsigned long) m_frame[5] << 16 |
+                    (unsigned long) m_frame[6] << 24);
+      isValid = true;
+    } else if (command == COMMAND_SET_COLOR && packetLength == 5 &&
+               device.type == RGB_LED_DEVICE) {
+      ((AnalogRGBLed*) device.device)->setRGBColor(m_frame[2],
+                                                   m_frame[3],
+                                                   m_frame[4]);
+      isValid = true;
+    } else if (command == COMMAND_SET_BRIGHTNESS && packetLength == 4 &&
+               device.type == ANALOG_LED_DEVICE) {
+      ((AnalogLed*) device.device)->setMaxBrightness(word(m_frame[3],
+                                                          m_frame[2]));
+      isValid = true;
+    }
+  }
+
+  return isValid;
+}
+
+void SerialControl::setDeviceMode(ControlDevice& device, byte mode,
+                                  unsigned long interval) {
+  device.mode = mode;
+  device.interval = interval;
+
+  if (mode == CONTROL_OFF) {
+    if (device.type == ANALOG_LED_DEVICE) {
+      ((AnalogLed*) device.device)->resetLed();
+    } else if (device.type == RGB_LED_DEVICE) {
+      ((AnalogRGBLed*) device.device)->resetRGBLed();
+    } else {
+      ((DigitalLed*) device.device)->resetLed();
+    }
+  }
+}
+
+void SerialControl::showLed(ControlDevice& device,
+                            unsigned long deltaMillis) {
+  if (device.type == ANALOG_LED_DEVICE) {
+    AnalogLed* led = (AnalogLed*) device.device;
+
+    if (device.mode == CONTROL_BLINK) {
+      led->showBlinkingLed(deltaMillis, device.interval);
+    } else if (device.mode == CONTROL_FADE_IN) {
+      led->showFadingInLed(deltaMillis, device.interval);
+    } else if (device.mode == CONTROL_FADE_OUT) {
+      led->showFadingOutLed(deltaMillis, device.interval);
+    } else if (device.mode == CONTROL_FADE_IN_OUT) {
+      led->showFadingInOutLed(deltaMillis, device.interval);
+    } else {
+      led->showSteadyLed(deltaMillis);
+    }
+  } else if (device.type == RGB_LED_DEVICE) {
+    AnalogRGBLed* led = (AnalogRGBLed*) device.device;
+
+    if (device.mode == CONTROL_BLINK) {
+      led->showBlinkingRGBLed(deltaMillis, device.interval);
+    } else if (device.mode == CONTROL_FADE_IN) {
+      led->showFadingInRGBLed(deltaMillis, device.interval);
+    } else if (device.mode == CONTROL_FADE_OUT) {
+      led->showFadingOutRGBLed(deltaMillis, device.interval);
+    } else if (device.mode == CONTROL_FADE_IN_OUT) {
+      led->showFadingInOutRGBLed(deltaMillis, device.interval);
+    } else {
+      led->showSteadyRGBLed(deltaMillis);
+    }
+  } else {
+    DigitalLed* led = (DigitalLed*) device.device;
+
+    if (device.mode == CONTROL_BLINK) {
+      led->showBlinkingLed(deltaMillis, device.interval);
+    } else {
+      led->showSteadyLed(deltaMillis);
+    }
+  }
+}
+
+void SerialControl::writeFrame(byte packet[], byte packetLength) {
+  unsigned int crc = 0xFFFF;
+  byte blockStart = 0;
+
+  for (byte i = 0; i < packetLength; i++) {
+    crc = _crc16_update(crc, packet[i]);
+  }
+
+  packet[packetLength] = lowByte(crc);
+  packet[packetLength + 1] = highByte(crc);
+  packetLength += 2;
+
+  // Each 0 byte in the packet ends a block, which is written straight
+  // from the packet after its code byte.
+  for (byte i = 0; i < packetLength; i++) {
+    if (packet[i] == 0) {
+      writeBlock(packet + blockStart, i - blockStart);
+      blockStart = i + 1;
+    }
+  }
+
+  writeBlock(packet + blockStart, packetLength - blockStart);
+  m_stream.write((byte) 0);
+}
+
+void SerialControl::writeBlock(const byte block[], byte blockLength) {
+  m_stream.write(blockLength + 1);
+  m_stream.write(block, blockLength);
+}
+
+SerialControl::~SerialControl() {
+
+}
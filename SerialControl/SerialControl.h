@@ -0,0 +1,226 @@
+/**
+ * SerialControl class.
+ *
+ * This class lets a host control the LED libraries and receive push
+ * button events over a serial port with a compact binary protocol.
+ * Each frame is a packet encoded with COBS (Consistent Overhead Byte
+ * Stuffing) and ended with a 0 byte, so a frame boundary can always be
+ * found again after a lost byte. Each packet is a command byte, a 
+ * device number, the arguments and a CRC16 of all of these, low byte 
+ * first. Multibyte arguments are also sent low byte first.
+ *
+ * Commands from the host:
+ *   COMMAND_SET_MODE       device, ControlMode, interval (4 bytes)
+ *   COMMAND_SET_COLOR      device, red, green, blue (RGB LED only)
+ *   COMMAND_SET_BRIGHTNESS device, brightness (2 bytes, analog LED 
+ *                          only)
+ * Events to the host:
+ *   EVENT_BUTTON_PUSH      device
+ *
+ * Received bytes are taken from the serial port's interrupt-fed 
+ * receive buffer into one frame buffer, decoded in place once the 0
+ * byte arrives and read straight from the frame buffer, so there are
+ * no String objects or heap allocations. Frames that are too long, 
+ * fail the CRC or have bad arguments are dropped and counted.
+ *
+ * Devices are stored in an array supplied by the sketch. The LEDs 
+ * keep the mode set by the host, since updateDevices() calls their
+ * show function each loop.
+ *
+ * The serial port is only used through Stream, so the parsing can be
+ * checked on a host by passing a buffer-backed Stream. The cost per
+ * command on the board can be measured by calling readCommands() from
+ * an UpdateBenchmark update function.
+ *
+ * @author Janette H. Griggs
+ * @version 1.1 10/19/26
+ */
+
+#ifndef SerialControl_h
+  #define SerialControl_h
+
+#ifndef __AVR_ATmega328P__
+  #define __AVR_ATmega328P__
+#endif
+#ifndef Arduino_h
+  #include <Arduino.h>
+#endif
+#ifndef AnalogLed_h
+  #include <AnalogLed.h>
+#endif
+#ifndef AnalogRGBLed_h
+  #include <AnalogRGBLed.h>
+#endif
+#ifndef DigitalLed_h
+  #include <DigitalLed.h>
+#endif
+#ifndef PushButton_h
+  #include <PushButton.h>
+#endif
+#ifndef ControlDevice_h
+  #include "ControlDevice.h"
+#endif
+
+class SerialControl {
+  public:
+    static const int NO_DEVICE = -1; /**< device number when a device 
+                                     can't be added */
+    static const byte COMMAND_SET_MODE = 0x01; /**< set LED mode */
+    static const byte COMMAND_SET_COLOR = 0x02; /**< set RGB LED color */
+    static const byte COMMAND_SET_BRIGHTNESS = 0x03; /**< set analog LED
+                                                     maximum 
+                                                     brightness */
+    static const byte EVENT_BUTTON_PUSH = 0x81; /**< push button was 
+                                                pushed */
+    static const byte MAX_FRAME_SIZE = 16; /**< longest encoded frame,
+                                           without the 0 byte */
+
+    /**
+     * Constructor.
+     * @param stream The serial port, e.g. Serial. It must be started 
+     * with begin() by the sketch.
+     * @param devices The array to store the devices in. The array must
+     * exist for as long as the SerialControl object does.
+     * @param deviceCapacity The number of devices the array holds.
+     */
+    SerialControl(Stream& stream, ControlDevice devices[],
+                  byte deviceCapacity);
+
+    /**
+     * Returns the number of devices.
+     * @return The device count.
+     */
+    byte getDeviceCount() const;
+
+    /**
+     * Returns the mode of an LED, as last set by the host.
+     * @param deviceNumber The device number returned when the LED was
+     * added.
+     * @return The ControlMode.
+     */
+    ControlMode getDeviceMode(byte deviceNumber) const;
+
+    /**
+     * Returns the number of commands that were carried out.
+     * @return The command count.
+     */
+    unsigned long getCommandCount() const;
+
+    /**
+     * Returns the number of frames that were dropped.
+     * @return The frame error count.
+     */
+    unsigned int getFrameErrorCount() const;
+
+    /**
+     * Adds an analog LED. The LED starts in the CONTROL_OFF mode.
+     * @param led The LED.
+     * @return The device number, or NO_DEVICE if the device array is
+     * full.
+     */
+    int addAnalogLed(AnalogLed& led);
+
+    /**
+     * Adds an RGB LED. The LED starts in the CONTROL_OFF mode.
+     * @param led The LED.
+     * @return The device number, or NO_DEVICE if the device array is
+     * full.
+     */
+    int addRGBLed(AnalogRGBLed& led);
+
+    /**
+     * Adds a digital LED. The LED starts in the CONTROL_OFF mode. 
+     * Fading modes are shown as a steady LED.
+     * @param led The LED.
+     * @return The device number, or NO_DEVICE if the device array is
+     * full.
+     */
+    int addDigitalLed(DigitalLed& led);
+
+    /**
+     * Adds a push button, which sends an EVENT_BUTTON_PUSH each time it
+     * is pushed.
+     * @param button The push button.
+     * @param debounceDelay The debounce delay (in ms) of the button.
+     * @return The device number, or NO_DEVICE if the device array is
+     * full.
+     */
+    int addPushButton(PushButton& button, unsigned long debounceDelay);
+
+    /**
+     * Reads the bytes that have arrived and carries out each command
+     * whose frame is complete. Does not wait for more bytes.
+     * NOTE: Call this function during each loop.
+     */
+    void readCommands();
+
+    /**
+     * Shows each LED in its mode and sends an event for each push 
+     * button that was pushed.
+     * NOTE: Call this function during each loop.
+     * @param deltaMillis The change in time (ms) from the previous loop.
+     */
+    void updateDevices(unsigned long deltaMillis);
+
+    /**
+     * Destructor.
+     */
+    ~SerialControl();
+  private:
+    Stream& m_stream; /**< serial port */
+    ControlDevice* m_devices; /**< devices, in the order they were 
+                              added */
+    byte m_deviceCapacity; /**< size of the device array */
+    byte m_deviceCount; /**< number of devices */
+    byte m_frame[MAX_FRAME_SIZE]; /**< frame being received */
+    byte m_frameLength; /**< number of bytes in the frame buffer */
+    bool m_isDiscardingFrame; /**< frame is too long and is skipped up
+                              to the next 0 byte */
+    unsigned long m_commandCount; /**< number of commands carried out */
+    unsigned int m_frameErrorCount; /**< number of frames dropped */
+
+    /**
+     * Adds a device of any type.
+     */
+    int addDevice(ControlDeviceType type, void* device,
+                  unsigned long interval);
+
+    /**
+     * Decodes the frame buffer in place and checks the CRC.
+     * @return The packet length without the CRC, or 0 if the frame is
+     * not valid.
+     */
+    byte decodeFrame();
+
+    /**
+     * Carries out the command in the decoded frame buffer.
+     * @return true if the command and its arguments are valid.
+     */
+    bool runCommand(byte packetLength);
+
+    /**
+     * Sets the mode of an LED and resets it when the mode is 
+     * CONTROL_OFF.
+     */
+    void setDeviceMode(ControlDevice& device, byte mode,
+                       unsigned long interval);
+
+    /**
+     * Shows an LED in its mode.
+     */
+    void showLed(ControlDevice& device, unsigned long deltaMillis);
+
+    /**
+     * Adds the CRC to a packet, encodes it as a frame and writes it.
+     * The packet array must have room for the 2 CRC bytes.
+     */
+    void writeFrame(byte packet[], byte packetLength);
+
+    /**
+     * Writes one block of a COBS frame, from its code byte up to the 
+     * next 0 byte or end of the packet.
+     */
+    void writeBlock(const byte block[], byte blockLength);
+};
+
+#endif
@@ -0,0 +1,33 @@
+// SchedulerTask struct for a task run by TaskScheduler.
+
+// @author Janette H. Griggs
+// @version 1.0 10/19/26
+
+#ifndef SchedulerTask_h
+  #define SchedulerTask_h
+
+#ifndef __AVR_ATmega328P__
+  #define __AVR_ATmega328P__
+#endif
+#ifndef Arduino_h
+  #include <Arduino.h>
+#endif
+
+/**
+ * Function that updates one or more devices, e.g. by calling
+ * AnalogLed::showFadingInLed() or PushButton::detectPush().
+ */
+typedef void (*TaskFunction)(unsigned long deltaMillis);
+
+struct SchedulerTask {
+  TaskFunction function; /**< task function */
+  unsigned long period; /**< time (ms) between runs */
+  byte priority; /**< priority, higher runs first */
+  unsigned long elapsedTimer; /**< time (ms) since the last run */
+  unsigned int overrunCount; /**< number of runs at least one period 
+                             late */
+  unsigned long maxLateness; /**< longest time (ms) past the period */
+  byte nextTask; /**< number of the task that runs after this one */
+};
+
+#endif
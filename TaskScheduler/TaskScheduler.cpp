@@ -0,0 +1,115 @@
+// Function definitions for the TaskScheduler class.
+
+// @author Janette H. Griggs
+// @version 1.0 10/19/26
+
+#include "TaskScheduler.h"
+
+TaskScheduler::TaskScheduler(SchedulerTask tasks[], byte taskCapacity,
+                             unsigned long budgetMicros) {
+  m_tasks = tasks;
+  m_taskCapacity = taskCapacity;
+  m_taskCount = 0;
+  m_firstTask = 0;
+  m_budgetMicros = budgetMicros;
+  m_budgetOverrunCount = 0;
+}
+
+byte TaskScheduler::getTaskCount() const {
+  return m_taskCount;
+}
+
+unsigned int TaskScheduler::getOverrunCount(byte taskNumber) const {
+  return m_tasks[taskNumber].overrunCount;
+}
+
+unsigned long TaskScheduler::getMaxLateness(byte taskNumber) const {
+  return m_tasks[taskNumber].maxLateness;
+}
+
+unsigned int TaskScheduler::getBudgetOverrunCount() const {
+  return m_budgetOverrunCount;
+}
+
+int TaskScheduler::addTask(TaskFunction function, unsigned long period,
+                           byte priority) {
+  int taskNumber = NO_TASK;
+  byte previousTask;
+
+  if (m_taskCount < m_taskCapacity) {
+    taskNumber = m_taskCount;
+
+    m_tasks[taskNumber].function = function;
+    m_tasks[taskNumber].period = period;
+    m_tasks[taskNumber].priority = priority;
+    m_tasks[taskNumber].elapsedTimer = 0L;
+    m_tasks[taskNumber].overrunCount = 0;
+    m_tasks[taskNumber].maxLateness = 0L;
+
+    // Link the task in after the last task with the same or higher
+    // priority, so the tasks never have to be sorted while running.
+    if (m_taskCount == 0 || m_tasks[m_firstTask].priority < priority) {
+      m_tasks[taskNumber].nextTask = m_firstTask;
+      m_firstTask = taskNumber;
+    } else {
+      previousTask = m_firstTask;
+
+      for (byte i = 1; i < m_taskCount &&
+           m_tasks[m_tasks[previousTask].nextTask].priority >= priority;
+           i++) {
+        previousTask = m_tasks[previousTask].nextTask;
+      }
+
+      m_tasks[taskNumber].nextTask = m_tasks[previousTask].nextTask;
+      m_tasks[previousTask].nextTask = taskNumber;
+    }
+
+    m_taskCount++;
+  }
+
+  return taskNumber;
+}
+
+void TaskScheduler::runTasks(unsigned long deltaMillis) {
+  unsigned long startMicros = micros();
+  unsigned long lateness;
+  bool isOverBudget = false;
+  byte taskNumber = m_firstTask;
+
+  for (byte i = 0; i < m_taskCount; i++) {
+    SchedulerTask& task = m_tasks[taskNumber];
+
+    task.elapsedTimer += deltaMillis;
+
+    // Tasks that are put off keep their elapsed time, so they catch
+    // up on the next loop.
+    if (task.elapsedTimer >= task.period) {
+      if (m_budgetMicros > 0 && micros() - startMicros >= m_budgetMicros) {
+        isOverBudget = true;
+      } else {
+        lateness = task.elapsedTimer - task.period;
+
+        if (task.period > 0 && lateness >= task.period) {
+          task.overrunCount++;
+        }
+
+        if (lateness > task.maxLateness) {
+          task.maxLateness = lateness;
+        }
+
+        task.function(task.elapsedTimer);
+        task.elapsedTimer = 0L;
+      }
+    }
+
+    taskNumber = task.nextTask;
+  }
+
+  if (isOverBudget) {
+    m_budgetOverrunCount++;
+  }
+}
+
+TaskScheduler::~TaskScheduler() {
+
+}
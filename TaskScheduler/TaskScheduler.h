@@ -0,0 +1,114 @@
+/**
+ * TaskScheduler class.
+ *
+ * This is a cooperative scheduler for the LED and push button 
+ * libraries. Each task is a function that updates one or more devices
+ * and is registered with a period and a priority. Instead of calling
+ * every device each loop, the scheduler runs a task only once its
+ * period has passed, and passes it all the time since its last run, so
+ * LEDs can be updated only as often as is visually necessary while
+ * their timing stays the same. Buttons get a short period and a high
+ * priority so they are polled at a steady rate.
+ *
+ * Due tasks run in order of priority. With a time budget, lower 
+ * priority tasks are put off to the next loop once the budget is used
+ * up. A task that runs a full period or more late is counted as an
+ * overrun.
+ *
+ * Tasks are stored in an array supplied by the sketch, so nothing is
+ * allocated at run time.
+ *
+ * @author Janette H. Griggs
+ * @version 1.0 10/19/26
+ */
+
+#ifndef TaskScheduler_h
+  #define TaskScheduler_h
+
+#ifndef __AVR_ATmega328P__
+  #define __AVR_ATmega328P__
+#endif
+#ifndef Arduino_h
+  #include <Arduino.h>
+#endif
+#ifndef SchedulerTask_h
+  #include "SchedulerTask.h"
+#endif
+
+class TaskScheduler {
+  public:
+    static const int NO_TASK = -1; /**< task number when a task can't be
+                                   added */
+
+    /**
+     * Constructor.
+     * @param tasks The array to store the tasks in. The array must
+     * exist for as long as the scheduler does.
+     * @param taskCapacity The number of tasks the array holds.
+     * @param budgetMicros The time (us) the tasks may take per loop
+     * before lower priority tasks are put off, or 0 for no budget.
+     */
+    TaskScheduler(SchedulerTask tasks[], byte taskCapacity,
+                  unsigned long budgetMicros = 0);
+
+    /**
+     * Returns the number of tasks.
+     * @return The task count.
+     */
+    byte getTaskCount() const;
+
+    /**
+     * Returns the number of runs of a task that were at least one
+     * period late.
+     * @param taskNumber The task number returned by addTask().
+     * @return The overrun count.
+     */
+    unsigned int getOverrunCount(byte taskNumber) const;
+
+    /**
+     * Returns the longest time (in ms) a task has run past its period.
+     * @param taskNumber The task number returned by addTask().
+     * @return The maximum lateness.
+     */
+    unsigned long getMaxLateness(byte taskNumber) const;
+
+    /**
+     * Returns the number of loops in which the time budget was used up
+     * before all due tasks had run.
+     * @return The budget overrun count.
+     */
+    unsigned int getBudgetOverrunCount() const;
+
+    /**
+     * Adds a task. Tasks with the same priority run in the order they
+     * were added.
+     * @param function The task function.
+     * @param period The time (ms) between runs, or 0 to run each loop.
+     * @param priority The priority, where higher runs first.
+     * @return The task number, or NO_TASK if the task array is full.
+     */
+    int addTask(TaskFunction function, unsigned long period,
+                byte priority);
+
+    /**
+     * Runs the tasks that are due, in order of priority.
+     * NOTE: Call this function during each loop.
+     * @param deltaMillis The change in time (ms) from the previous loop.
+     */
+    void runTasks(unsigned long deltaMillis);
+
+    /**
+     * Destructor.
+     */
+    ~TaskScheduler();
+  private:
+    SchedulerTask* m_tasks; /**< tasks, in the order they were added */
+    byte m_taskCapacity; /**< size of the task array */
+    byte m_taskCount; /**< number of tasks */
+    byte m_firstTask; /**< number of the task with the highest 
+                      priority */
+    unsigned long m_budgetMicros; /**< time budget (us) per loop */
+    unsigned int m_budgetOverrunCount; /**< number of loops over budget */
+};
+
+#endif
@@ -0,0 +1,296 @@
+// Function definitions for the UpdateBenchmark class.
+
+// @author Janette H. Griggs
+// @version 1.2 10/19/26
+
+#include "UpdateBenchmark.h"
+
+unsigned long UpdateBenchmark::s_writeCount = 0L;
+AnalogLed* UpdateBenchmark::s_analogLed = NULL;
+AnalogRGBLed* UpdateBenchmark::s_rgbLed = NULL;
+DigitalLed* UpdateBenchmark::s_digitalLed = NULL;
+PushButton* UpdateBenchmark::s_button = NULL;
+PushButton::ReadFunction UpdateBenchmark::s_previousReadFunction = NULL;
+unsigned int UpdateBenchmark::s_buttonReadCount = 0;
+
+UpdateBenchmark::UpdateBenchmark(Print& output, 
+                                 unsigned long deltaMillis) :
+    m_output(output) {
+  m_deltaMillis = deltaMillis;
+  m_updateNanos = 0L;
+  m_writesPerThousandUpdates = 0L;
+  m_ledsPerSecond = 0L;
+}
+
+void UpdateBenchmark::writeHeader() {
+  m_output.println("name,updates,ns_per_update,writes_per_1000_updates,"
+                   "size_bytes");
+}
+
+void UpdateBenchmark::run(const char* name, unsigned int objectSize,
+                          unsigned long updateCount,
+                          UpdateFunction updateFunction) {
+  unsigned long updateMicros;
+  AnalogLed::WriteObserver previousAnalogObserver = 
+      AnalogLed::getWriteObserver();
+  DigitalLed::WriteObserver previousDigitalObserver = 
+      DigitalLed::getWriteObserver();
+
+  s_writeCount = 0L;
+  AnalogLed::setWriteObserver(countWrite);
+  DigitalLed::setWriteObserver(countWrite);
+
+  // The write counting itself takes time, but far less than a write.
+  updateMicros = measureUpdateMicros(updateCount, updateFunction);
+
+  AnalogLed::setWriteObserver(previousAnalogObserver);
+  DigitalLed::setWriteObserver(previousDigitalObserver);
+
+  m_updateNanos = (unsigned long) 
+      ((float) updateMicros * 1000 / updateCount);
+  m_writesPerThousandUpdates = (unsigned long) 
+      ((float) s_writeCount * 1000 / updateCount);
+
+  m_output.print(name);
+  m_output.print(',');
+  m_output.print(updateCount);
+  m_output.print(',');
+  m_output.print(m_updateNanos);
+  m_output.print(',');
+  m_output.print(m_writesPerThousandUpdates);
+  m_output.print(',');
+  m_output.println(objectSize);
+}
+
+void UpdateBenchmark::writeBatchHeader() {
+  m_output.println("name,leds,updates,leds_per_second");
+}
+
+void UpdateBenchmark::runBatch(const char* name, unsigned int ledCount,
+                               unsigned long updateCount,
+                               UpdateFunction updateFunction) {
+  unsigned long updateMicros = measureUpdateMicros(updateCount, 
+                                                   updateFunction);
+
+  if (updateMicros > 0) {
+    m_ledsPerSecond = (unsigned long) 
+        ((float) ledCount * updateCount * 1000000 / updateMicros);
+  } else {
+    m_ledsPerSecond = 0L;
+  }
+
+  m_output.print(name);
+  m_output.print(',');
+  m_output.print(ledCount);
+  m_output.print(',');
+  m_output.print(updateCount);
+  m_output.print(',');
+  m_output.println(m_ledsPerSecond);
+}
+
+void UpdateBenchmark::runSuite(unsigned long updateCount) {
+  static const char* const cathodeNames[] = {
+    "AnalogLed cathode steady", "AnalogLed cathode blink",
+    "AnalogLed cathode fade in", "AnalogLed cathode fade out",
+    "AnalogLed cathode fade in/out"
+  };
+  static const char* const anodeNames[] = {
+    "AnalogLed anode steady", "AnalogLed anode blink",
+    "AnalogLed anode fade in", "AnalogLed anode fade out",
+    "AnalogLed anode fade in/out"
+  };
+  AnalogLed cathodeLed(3);
+  AnalogLed anodeLed(3, 0, 255, COMMON_ANODE);
+  AnalogRGBLed rgbLed(9, 10, 11, 255, 255, 255, COMMON_CATHODE);
+  DigitalLed digitalLed(13);
+  PushButton button(2, PULL_UP);
+
+  s_analogLed = &cathodeLed;
+  runAnalogLedSuite(cathodeNames, updateCount);
+  cathodeLed.resetLed();
+
+  s_analogLed = &anodeLed;
+  runAnalogLedSuite(anodeNames, updateCount);
+  anodeLed.resetLed();
+
+  s_rgbLed = &rgbLed;
+  rgbLed.resetRGBLed();
+  run("AnalogRGBLed steady", sizeof(AnalogRGBLed), updateCount,
+      updateRGBSteady);
+  rgbLed.resetRGBLed();
+  run("AnalogRGBLed blink", sizeof(AnalogRGBLed), updateCount,
+      updateRGBBlinking);
+  rgbLed.resetRGBLed();
+  run("AnalogRGBLed fade in", sizeof(AnalogRGBLed), updateCount,
+      updateRGBFadingIn);
+  rgbLed.resetRGBLed();
+  run("AnalogRGBLed fade out", sizeof(AnalogRGBLed), updateCount,
+      updateRGBFadingOut);
+  rgbLed.resetRGBLed();
+  run("AnalogRGBLed fade in/out", sizeof(AnalogRGBLed), updateCount,
+      updateRGBFadingInOut);
+  rgbLed.resetRGBLed();
+
+  s_digitalLed = &digitalLed;
+  digitalLed.resetLed();
+  run("DigitalLed steady", sizeof(DigitalLed), updateCount,
+      updateDigitalSteady);
+  digitalLed.resetLed();
+  run("DigitalLed blink", sizeof(DigitalLed), updateCount,
+      updateDigitalBlinking);
+  digitalLed.resetLed();
+
+  s_button = &button;
+  s_buttonReadCount = 0;
+  s_previousReadFunction = PushButton::getReadFunction();
+  PushButton::setReadFunction(readBouncingButton);
+  button.resetButton();
+  run("PushButton bouncing detectPush", sizeof(PushButton), updateCount,
+      updateButton);
+  PushButton::setReadFunction(s_previousReadFunction);
+
+  s_analogLed = NULL;
+  s_rgbLed = NULL;
+  s_digitalLed = NULL;
+  s_button = NULL;
+}
+
+unsigned long UpdateBenchmark::getUpdateNanos() const {
+  return m_updateNanos;
+}
+
+unsigned long UpdateBenchmark::getWritesPerThousandUpdates() const {
+  return m_writesPerThousandUpdates;
+}
+
+unsigned long UpdateBenchmark::getLedsPerSecond() const {
+  return m_ledsPerSecond;
+}
+
+UpdateBenchmark::~UpdateBenchmark() {
+
+}
+
+unsigned long UpdateBenchmark::measureMicros(unsigned long updateCount,
+    UpdateFunction updateFunction) const {
+  unsigned long startMicros = micros();
+
+  for (unsigned long i = 0; i < updateCount; i++) {
+    updateFunction(m_deltaMillis);
+  }
+
+  return micros() - startMicros;
+}
+
+unsigned long UpdateBenchmark::measureUpdateMicros(
+    unsigned long updateCount, UpdateFunction updateFunction) const {
+  unsigned long emptyMicros = measureMicros(updateCount, updateNothing);
+  unsigned long updateMicros = measureMicros(updateCount, updateFunction);
+
+  if (updateMicros > emptyMicros) {
+    updateMicros -= emptyMicros;
+  } else {
+    updateMicros = 0L;
+  }
+
+  return updateMicros;
+}
+
+void UpdateBenchmark::runAnalogLedSuite(const char* const names[],
+                                        unsigned long updateCount) {
+  s_analogLed->resetLed();
+  run(names[0], sizeof(AnalogLed), updateCount, updateAnalogSteady);
+  s_analogLed->resetLed();
+  run(names[1], sizeof(AnalogLed), updateCount, updateAnalogBlinking);
+  s_analogLed->resetLed();
+  run(names[2], sizeof(AnalogLed), updateCount, updateAnalogFadingIn);
+  s_analogLed->resetLed();
+  run(names[3], sizeof(AnalogLed), updateCount, updateAnalogFadingOut);
+  s_analogLed->resetLed();
+  run(names[4], sizeof(AnalogLed), updateCount, updateAnalogFadingInOut);
+}
+
+void UpdateBenchmark::countWrite(int, unsigned int) {
+  s_writeCount++;
+}
+
+void UpdateBenchmark::updateNothing(unsigned long) {
+
+}
+
+int UpdateBenchmark::readBouncingButton(int pinNumber) {
+  int reading;
+  unsigned int readIndex;
+
+  if (s_button != NULL && pinNumber == s_button->getButtonPinNumber()) {
+    // Each press and each release starts with alternating reads.
+    readIndex = s_buttonReadCount % (2 * PUSH_READ_COUNT);
+    s_buttonReadCount++;
+
+    if (readIndex % PUSH_READ_COUNT < BOUNCE_READ_COUNT) {
+      reading = readIndex % 2 == 0 ? LOW : HIGH;
+    } else if (readIndex < PUSH_READ_COUNT) {
+      reading = s_button->getActiveValue();
+    } else {
+      reading = !s_button->getActiveValue();
+    }
+  } else if (s_previousReadFunction != NULL) {
+    reading = s_previousReadFunction(pinNumber);
+  } else {
+    reading = digitalRead(pinNumber);
+  }
+
+  return reading;
+}
+
+void UpdateBenchmark::updateAnalogSteady(unsigned long deltaMillis) {
+  s_analogLed->showSteadyLed(deltaMillis);
+}
+
+void UpdateBenchmark::updateAnalogBlinking(unsigned long deltaMillis) {
+  s_analogLed->showBlinkingLed(deltaMillis, SUITE_BLINK_INTERVAL);
+}
+
+void UpdateBenchmark::updateAnalogFadingIn(unsigned long deltaMillis) {
+  s_analogLed->showFadingInLed(deltaMillis, SUITE_FADE_INTERVAL);
+}
+
+void UpdateBenchmark::updateAnalogFadingOut(unsigned long deltaMillis) {
+  s_analogLed->showFadingOutLed(deltaMillis, SUITE_FADE_INTERVAL);
+}
+
+void UpdateBenchmark::updateAnalogFadingInOut(unsigned long deltaMillis) {
+  s_analogLed->showFadingInOutLed(deltaMillis, SUITE_FADE_INTERVAL);
+}
+
+void UpdateBenchmark::updateRGBSteady(unsigned long deltaMillis) {
+  s_rgbLed->showSteadyRGBLed(deltaMillis);
+}
+
+void UpdateBenchmark::updateRGBBlinking(unsigned long deltaMillis) {
+  s_rgbLed->showBlinkingRGBLed(deltaMillis, SUITE_BLINK_INTERVAL);
+}
+
+void UpdateBenchmark::updateRGBFadingIn(unsigned long deltaMillis) {
+  s_rgbLed->showFadingInRGBLed(deltaMillis, SUITE_FADE_INTERVAL);
+}
+
+void UpdateBenchmark::updateRGBFadingOut(unsigned long deltaMillis) {
+  s_rgbLed->showFadingOutRGBLed(deltaMillis, SUITE_FADE_INTERVAL);
+}
+
+void UpdateBenchmark::updateRGBFadingInOut(unsigned long deltaMillis) {
+  s_rgbLed->showFadingInOutRGBLed(deltaMillis, SUITE_FADE_INTERVAL);
+}
+
+void UpdateBenchmark::updateDigitalSteady(unsigned long deltaMillis) {
+  s_digitalLed->showSteadyLed(deltaMillis);
+}
+
+void UpdateBenchmark::updateDigitalBlinking(unsigned long deltaMillis) {
+  s_digitalLed->showBlinkingLed(deltaMillis, SUITE_BLINK_INTERVAL);
+}
+
+void UpdateBenchmark::updateButton(unsigned long deltaMillis) {
+  s_button->detectPush(deltaMillis, SUITE_DEBOUNCE_DELAY);
+}
@@ -0,0 +1,252 @@
+/**
+ * UpdateBenchmark class.
+ *
+ * This class measures the cost of updating the LED and push button
+ * libraries on the Arduino Uno. It calls an update function, such as
+ * one call of AnalogLed::showFadingInOutLed(), a given number of times
+ * and reports the time per update, the number of pin writes per 
+ * update and the object size as one CSV line, so results can be 
+ * compared between versions of the libraries.
+ *
+ * The time of calling an empty update function is measured once and
+ * subtracted, so the results only include the library code.
+ *
+ * runSuite() measures a fixed set of modes, so results of different
+ * versions cover the same updates: each AnalogLed mode for both LED
+ * types, each AnalogRGBLed mode, DigitalLed steady and blinking and
+ * PushButton::detectPush() with a bouncing reading.
+ *
+ * runBatch() measures the throughput in LEDs per second of an update
+ * function that updates many LEDs, e.g. AnalogLedBatch against a loop
+ * over AnalogLed objects, on the Arduino or a host computer.
+ *
+ * Example:
+ *   AnalogLed led(3);
+ *   UpdateBenchmark benchmark(Serial);
+ *   benchmark.writeHeader();
+ *   benchmark.run("AnalogLed fade in/out", sizeof(AnalogLed), 10000,
+ *       [](unsigned long deltaMillis) { 
+ *         led.showFadingInOutLed(deltaMillis, 1000); 
+ *       });
+ *   benchmark.runSuite(10000);
+ *
+ *   AnalogLed leds[6] = {AnalogLed(3), AnalogLed(5), AnalogLed(6),
+ *                        AnalogLed(9), AnalogLed(10), AnalogLed(11)};
+ *   uint32_t timers[6];
+ *   bool isFadingIn[6];
+ *   unsigned int outputs[6];
+ *   AnalogLedBatch batch(timers, isFadingIn, outputs, 6, 0, 255);
+ *   benchmark.writeBatchHeader();
+ *   benchmark.runBatch("AnalogLed fade in/out", 6, 1000,
+ *       [](unsigned long deltaMillis) {
+ *         for (int i = 0; i < 6; i++) {
+ *           leds[i].showFadingInOutLed(deltaMillis, 1000);
+ *         }
+ *       });
+ *   benchmark.runBatch("AnalogLedBatch fade in/out", 6, 1000,
+ *       [](unsigned long deltaMillis) {
+ *         batch.updateFadingInOut(deltaMillis, 1000);
+ *       });
+ *
+ * @author Janette H. Griggs
+ * @version 1.2 10/19/26
+ */
+
+#ifndef UpdateBenchmark_h
+  #define UpdateBenchmark_h
+
+#ifndef __AVR_ATmega328P__
+  #define __AVR_ATmega328P__
+#endif
+#ifndef Arduino_h
+  #include <Arduino.h>
+#endif
+#ifndef AnalogLed_h
+  #include <AnalogLed.h>
+#endif
+#ifndef AnalogRGBLed_h
+  #include <AnalogRGBLed.h>
+#endif
+#ifndef DigitalLed_h
+  #include <DigitalLed.h>
+#endif
+#ifndef PushButton_h
+  #include <PushButton.h>
+#endif
+
+class UpdateBenchmark {
+  public:
+    /**
+     * Function that updates the devices being measured once.
+     */
+    typedef void (*UpdateFunction)(unsigned long deltaMillis);
+
+    /**
+     * Constructor.
+     * @param output The output to write the results to, e.g. Serial.
+     * @param deltaMillis The change in time (ms) passed to each update.
+     */
+    UpdateBenchmark(Print& output, unsigned long deltaMillis = 1);
+
+    /**
+     * Writes the CSV header line.
+     */
+    void writeHeader();
+
+    /**
+     * Measures an update function and writes one CSV line with the
+     * name, number of updates, time per update (ns), pin writes per 
+     * update and object size (bytes).
+     * NOTE: The write observers of AnalogLed and DigitalLed are used
+     * to count writes. The observers set before are not called during
+     * the measurement and are restored afterwards.
+     * @param name The name of the measurement.
+     * @param objectSize The size of the objects being updated.
+     * @param updateCount The number of updates.
+     * @param updateFunction The update function.
+     */
+    void run(const char* name, unsigned int objectSize,
+             unsigned long updateCount, UpdateFunction updateFunction);
+
+    /**
+     * Measures the standard suite of update modes, writing one CSV line
+     * per mode as run() does. Each device is reset before each mode.
+     * The push button reading bounces for 5 reads at each press and
+     * release, and each press is held for 45 reads, with a debounce
+     * delay of 20 ms.
+     * NOTE: The suite drives pins 3 (AnalogLed), 9, 10 and 11
+     * (AnalogRGBLed) and 13 (DigitalLed), so nothing else should be
+     * wired to them. The push button on pin 2 is fed through
+     * PushButton::setReadFunction(), which is restored afterwards.
+     * @param updateCount The number of updates of each mode.
+     */
+    void runSuite(unsigned long updateCount);
+
+    /**
+     * Writes the CSV header line of runBatch().
+     */
+    void writeBatchHeader();
+
+    /**
+     * Measures an update function that updates many LEDs and writes 
+     * one CSV line with the name, number of LEDs, number of updates and
+     * LEDs updated per second. Pin writes are not counted.
+     * @param name The name of the measurement.
+     * @param ledCount The number of LEDs each update updates.
+     * @param updateCount The number of updates.
+     * @param updateFunction The update function.
+     */
+    void runBatch(const char* name, unsigned int ledCount,
+                  unsigned long updateCount, UpdateFunction updateFunction);
+
+    /**
+     * Returns the time per update (ns) of the last measurement.
+     * @return The update time.
+     */
+    unsigned long getUpdateNanos() const;
+
+    /**
+     * Returns the pin writes per 1000 updates of the last measurement.
+     * @return The write rate.
+     */
+    unsigned long getWritesPerThousandUpdates() const;
+
+    /**
+     * Returns the LEDs updated per second of the last runBatch().
+     * @return The LED throughput.
+     */
+    unsigned long getLedsPerSecond() const;
+
+    /**
+     * Destructor.
+     */
+    ~UpdateBenchmark();
+  private:
+    static const unsigned long SUITE_BLINK_INTERVAL = 500; /**< blink 
+                                                           interval of 
+                                                           the suite */
+    static const unsigned long SUITE_FADE_INTERVAL = 1000; /**< fade 
+                                                           interval of 
+                                                           the suite */
+    static const unsigned long SUITE_DEBOUNCE_DELAY = 20; /**< debounce 
+                                                          delay of the 
+                                                          suite */
+    static const unsigned int BOUNCE_READ_COUNT = 5; /**< bouncing reads 
+                                                     at each edge */
+    static const unsigned int PUSH_READ_COUNT = 50; /**< reads of each 
+                                                    press and of each 
+                                                    release */
+
+    static unsigned long s_writeCount; /**< pin writes counted */
+    static AnalogLed* s_analogLed; /**< AnalogLed of the suite */
+    static AnalogRGBLed* s_rgbLed; /**< AnalogRGBLed of the suite */
+    static DigitalLed* s_digitalLed; /**< DigitalLed of the suite */
+    static PushButton* s_button; /**< push button of the suite */
+    static PushButton::ReadFunction s_previousReadFunction; /**< read 
+                                                            function 
+                                                            before the 
+                                                            suite */
+    static unsigned int s_buttonReadCount; /**< reads of the suite's
+                                           push button */
+
+    Print& m_output; /**< output for the results */
+    unsigned long m_deltaMillis; /**< change in time for each update */
+    unsigned long m_updateNanos; /**< time per update (ns) */
+    unsigned long m_writesPerThousandUpdates; /**< pin writes per 1000 
+                                              updates */
+    unsigned long m_ledsPerSecond; /**< LEDs updated per second */
+
+    /**
+     * Returns the total time (us) of calling the update function.
+     */
+    unsigned long measureMicros(unsigned long updateCount,
+                                UpdateFunction updateFunction) const;
+
+    /**
+     * Returns the total time (us) of calling the update function, less
+     * the time of calling an empty update function as often.
+     */
+    unsigned long measureUpdateMicros(unsigned long updateCount,
+                                      UpdateFunction updateFunction) const;
+
+    /**
+     * Measures the AnalogLed modes of the suite.
+     */
+    void runAnalogLedSuite(const char* const names[],
+                           unsigned long updateCount);
+
+    /**
+     * Counts a pin write.
+     */
+    static void countWrite(int, unsigned int);
+
+    /**
+     * Does nothing, to measure the cost of the calls themselves.
+     */
+    static void updateNothing(unsigned long);
+
+    /**
+     * Returns a bouncing reading for the suite's push button, and reads
+     * other pins as before the suite.
+     */
+    static int readBouncingButton(int pinNumber);
+
+    /**
+     * Update functions of the suite.
+     */
+    static void updateAnalogSteady(unsigned long deltaMillis);
+    static void updateAnalogBlinking(unsigned long deltaMillis);
+    static void updateAnalogFadingIn(unsigned long deltaMillis);
+    static void updateAnalogFadingOut(unsigned long deltaMillis);
+    static void updateAnalogFadingInOut(unsigned long deltaMillis);
+    static void updateRGBSteady(unsigned long deltaMillis);
+    static void updateRGBBlinking(unsigned long deltaMillis);
+    static void updateRGBFadingIn(unsigned long deltaMillis);
+    static void updateRGBFadingOut(unsigned long deltaMillis);
+    static void updateRGBFadingInOut(unsigned long deltaMillis);
+    static void updateDigitalSteady(unsigned long deltaMillis);
+    static void updateDigitalBlinking(unsigned long deltaMillis);
+    static void updateButton(unsigned long deltaMillis);
+};
+
+#endif